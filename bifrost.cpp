@@ -121,13 +121,20 @@ void demonstrateAdvancedFeatures() {
     std::cout << "\nTesting collision strategies (INNER JOIN):\n";
     const std::vector<std::pair<CollisionStrategy, std::string>> strategies = {
         {CollisionStrategy::CHAINING, "Chaining"},
-        {CollisionStrategy::LINEAR_PROBING, "Linear Probing"}
+        {CollisionStrategy::LINEAR_PROBING, "Linear Probing"},
+        {CollisionStrategy::SWISS, "Swiss Table"},
+        {CollisionStrategy::ROBIN_HOOD, "Robin Hood"},
+        {CollisionStrategy::CUCKOO, "Cuckoo"}
     };
     
+    // "value" would otherwise take the direct-addressed path for every strategy
+    JoinOptions hashOnly;
+    hashOnly.directAddressing = false;
+
     for (const auto& [strategy, strategyName] : strategies) {
         std::cout << "\nUsing " << strategyName << " strategy:\n";
         auto result = engine.hashJoin(*leftTable, "value", *rightTable, "value", 
-                                     JoinType::INNER, strategy);
+                                     JoinType::INNER, strategy, hashOnly);
         engine.getProfiler().printReport();
     }
 }
@@ -145,6 +152,18 @@ void runComprehensiveTests() {
     
     std::cout << "\nRunning scalability benchmark...\n";
     benchmark.runScalabilityBenchmark();
+
+    std::cout << "\nRunning probe latency benchmark...\n";
+    benchmark.runProbeLatencyBenchmark();
+
+    std::cout << "\nRunning batched probe benchmark...\n";
+    benchmark.runBatchedProbeBenchmark();
+
+    std::cout << "\nRunning hash function benchmark...\n";
+    benchmark.runHashFunctionBenchmark();
+
+    std::cout << "\nRunning radix join benchmark...\n";
+    benchmark.runRadixJoinBenchmark();
 }
 
 void testMemoryManagement() {
@@ -158,8 +177,11 @@ void testMemoryManagement() {
     
     std::cout << "Table 1 memory usage: " << largeTable1->estimateMemoryUsage() / 1024 << " KB\n";
     std::cout << "Table 2 memory usage: " << largeTable2->estimateMemoryUsage() / 1024 << " KB\n";
+    std::cout << "Tracked table allocations: "
+              << MemoryTracker::counters(MemoryComponent::TABLE).current / 1024 << " KB\n";
     
     JoinEngine engine;
+    engine.getProfiler().setDetailedStats(true);
     std::cout << "\nPerforming large join operation...\n";
     auto startTime = std::chrono::high_resolution_clock::now();
     
@@ -175,6 +197,45 @@ void testMemoryManagement() {
     engine.getProfiler().printReport();
 }
 
+// save -> open round trip over every column kind, including the all-NULL
+// NULL_VALUE column loadFromCSV makes for an empty CSV column
+void testSnapshots() {
+    std::cout << "=== Snapshot Round Trip Test ===\n\n";
+
+    const std::string csvPath = "snapshot_test.csv";
+    const std::string snapshotPath = "snapshot_test.bfsnap";
+    {
+        std::ofstream csv(csvPath);
+        csv << "id,name,empty,score\n";
+        for (int i = 0; i < 20; ++i) {
+            csv << i << ",Item_" << i % 3 << ",," << i * 1.5 << "\n";
+        }
+    }
+
+    DataLoader loader;
+    auto csvTable = loader.loadFromCSV(csvPath, "CsvTable");
+    std::remove(csvPath.c_str());
+    auto generated = loader.generateTestTable("Generated", 1000, 7);
+
+    for (const Table* table : {csvTable.get(), generated.get()}) {
+        table->saveSnapshot(snapshotPath);
+        auto opened = Table::openSnapshot(snapshotPath);
+
+        bool same = opened->rowCount() == table->rowCount() && opened->columnCount() == table->columnCount();
+        for (size_t col = 0; same && col < table->columnCount(); ++col) {
+            same = opened->getSchema()[col].type == table->getSchema()[col].type;
+            for (size_t row = 0; same && row < table->rowCount(); ++row) {
+                same = opened->getColumn(col).valueAt(row) == table->getColumn(col).valueAt(row);
+            }
+        }
+        opened.reset();
+        std::remove(snapshotPath.c_str());
+
+        std::cout << table->getName() << ": " << table->rowCount() << " rows, "
+                  << table->columnCount() << " columns, " << (same ? "round trip OK" : "MISMATCH") << "\n";
+        if (!same) throw std::runtime_error("Snapshot round trip changed table " + table->getName());
+    }
+}
 
 int main(int argc, char*argv[]) {
     std::cout << "Bifrost - An implementation of Hash Tables in database joins" << std::endl;
@@ -201,13 +262,16 @@ int main(int argc, char*argv[]) {
                 runComprehensiveTests();
             } else if (arg == "--memory") {
                 testMemoryManagement();
+            } else if (arg == "--snapshot") {
+                testSnapshots();
             } else if (arg == "--all") {
                 demonstrateBasicUsage();
                 demonstrateAdvancedFeatures();
                 runComprehensiveTests();
                 testMemoryManagement();
+                testSnapshots();
             } else {
-                std::cout << "Usage: " << argv[0] << " [--demo|--advanced|--benchmark|--memory|--all]\n";
+                std::cout << "Usage: " << argv[0] << " [--demo|--advanced|--benchmark|--memory|--snapshot|--all]\n";
                 return 1;
             }
         } else {
@@ -219,6 +283,7 @@ int main(int argc, char*argv[]) {
             std::cout << "  --advanced  Advanced features demo\n";
             std::cout << "  --benchmark Comprehensive benchmarks\n";
             std::cout << "  --memory    Memory management tests\n";
+            std::cout << "  --snapshot  Snapshot save/open round trip\n";
             std::cout << "  --all       Run all tests\n";
         }
         
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+#include "MemoryTracker.h"
+
+// Bump-pointer allocator. Objects are carved out of large blocks and there
+// is no per-object free: everything goes at once in reset() or when the
+// arena is destroyed. Destructors are not run; owners that place
+// non-trivial objects here must call them before releasing the memory.
+// Blocks are reported to MemoryTracker under the arena's component.
+class Arena {
+private:
+    struct BlockDeleter {
+        MemoryComponent component;
+        size_t size;
+
+        void operator()(char* data) const {
+            MemoryTracker::released(component, size);
+            delete[] data;
+        }
+    };
+
+    struct Block {
+        std::unique_ptr<char[], BlockDeleter> data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks_;
+    char* cursor_ = nullptr;
+    char* limit_ = nullptr;
+    size_t nextBlockSize_;
+    size_t bytesReserved_ = 0;
+    MemoryComponent component_;
+
+    static constexpr size_t MIN_BLOCK_SIZE = 4096;
+    static constexpr size_t MAX_BLOCK_SIZE = 1 << 20;
+
+    void addBlock(size_t minBytes);
+
+public:
+    explicit Arena(size_t firstBlockSize = MIN_BLOCK_SIZE,
+                   MemoryComponent component = MemoryComponent::HASH_TABLE);
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena(Arena&&) = default;
+    Arena& operator=(Arena&&) = default;
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        uintptr_t aligned = (reinterpret_cast<uintptr_t>(cursor_) + alignment - 1) & ~(alignment - 1);
+        if (cursor_ == nullptr || aligned + bytes > reinterpret_cast<uintptr_t>(limit_)) {
+            addBlock(bytes + alignment);
+            aligned = (reinterpret_cast<uintptr_t>(cursor_) + alignment - 1) & ~(alignment - 1);
+        }
+        cursor_ = reinterpret_cast<char*>(aligned + bytes);
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // uninitialized storage for count objects of T
+    template<typename T>
+    T* allocateArray(size_t count) {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // drops every allocation; the largest block is kept for reuse
+    void reset();
+
+    size_t bytesReserved() const { return bytesReserved_; }
+    size_t blockCount() const { return blocks_.size(); }
+};
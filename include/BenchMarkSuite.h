@@ -8,4 +8,8 @@ class BenchmarkSuite {
         void runHashTableBenchmark();
         void runJoinTypeBenchmark();
         void runScalabilityBenchmark();
+        void runProbeLatencyBenchmark();
+        void runBatchedProbeBenchmark();
+        void runHashFunctionBenchmark();
+        void runRadixJoinBenchmark();
 };
\ No newline at end of file
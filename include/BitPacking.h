@@ -0,0 +1,86 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Frame-of-reference bit packing: value i is stored as value - reference in
+// `width` bits at bit i * width of a uint64_t array, so a run of values in a
+// narrow range takes width bits each instead of 64. A group of 64 values
+// fills exactly `width` words, which is the unit the unpack kernels work on.
+
+constexpr size_t PACK_GROUP = 64;
+
+// bits needed for deltas up to range
+inline unsigned bitWidthFor(uint64_t range) {
+    return range == 0 ? 0 : 64 - __builtin_clzll(range);
+}
+
+inline size_t packedWords(size_t count, unsigned width) {
+    return (count * width + 63) / 64;
+}
+
+inline void packValue(uint64_t* words, size_t i, unsigned width, uint64_t delta) {
+    if (width == 0) return;
+    size_t bit = i * width;
+    size_t word = bit >> 6;
+    unsigned shift = bit & 63;
+    words[word] |= delta << shift;
+    if (shift + width > 64) words[word + 1] |= delta >> (64 - shift);
+}
+
+inline int64_t unpackValue(const uint64_t* words, size_t i, unsigned width, int64_t reference) {
+    if (width == 0) return reference;
+    size_t bit = i * width;
+    size_t word = bit >> 6;
+    unsigned shift = bit & 63;
+    uint64_t v = words[word] >> shift;
+    if (shift + width > 64) v |= words[word + 1] << (64 - shift);
+    uint64_t mask = width == 64 ? ~0ULL : (1ULL << width) - 1;
+    return static_cast<int64_t>(static_cast<uint64_t>(reference) + (v & mask));
+}
+
+// unpacks one group of 64 values. With the width fixed at compile time every
+// word index and shift is a constant, so the unrolled loop is straight-line
+// shifts and masks the compiler can vectorize.
+template<unsigned Width>
+void unpackGroup(const uint64_t* words, int64_t reference, int64_t* out) {
+    constexpr uint64_t mask = Width == 64 ? ~0ULL : (1ULL << Width) - 1;
+#pragma GCC unroll 64
+    for (unsigned i = 0; i < PACK_GROUP; ++i) {
+        uint64_t v = 0;
+        if constexpr (Width > 0) {
+            const unsigned bit = i * Width;
+            const unsigned shift = bit & 63;
+            v = words[bit >> 6] >> shift;
+            if (shift + Width > 64) v |= words[(bit >> 6) + 1] << (64 - shift);
+        }
+        out[i] = static_cast<int64_t>(static_cast<uint64_t>(reference) + (v & mask));
+    }
+}
+
+using UnpackKernel = void (*)(const uint64_t*, int64_t, int64_t*);
+
+template<size_t... Widths>
+constexpr std::array<UnpackKernel, sizeof...(Widths)> makeUnpackKernels(std::index_sequence<Widths...>) {
+    return {{&unpackGroup<Widths>...}};
+}
+
+// kernel for each width 0..64, picked once per block
+inline UnpackKernel unpackKernel(unsigned width) {
+    static constexpr auto kernels = makeUnpackKernels(std::make_index_sequence<65>());
+    return kernels[width];
+}
+
+// unpacks values [begin, end): whole groups through the kernel, the ragged
+// ends one value at a time
+inline void unpackRange(const uint64_t* words, unsigned width, int64_t reference,
+                        size_t begin, size_t end, int64_t* out) {
+    size_t i = begin;
+    for (; i < end && i % PACK_GROUP != 0; ++i) *out++ = unpackValue(words, i, width, reference);
+    UnpackKernel kernel = unpackKernel(width);
+    for (; i + PACK_GROUP <= end; i += PACK_GROUP, out += PACK_GROUP) {
+        kernel(words + (i / PACK_GROUP) * width, reference, out);
+    }
+    for (; i < end; ++i) *out++ = unpackValue(words, i, width, reference);
+}
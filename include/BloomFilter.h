@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "HashFunction.h"
+#include "MemoryTracker.h"
+#include "Table.h"
+
+// Split-block Bloom filter: each key maps to one 256-bit block (eight 32-bit
+// words, a quarter of a cache line) and sets one bit in every word, so an
+// add or a lookup touches a single block and no other memory. At the
+// default 10 bits per key the false-positive rate is around 1%.
+//
+// Keys come in as 64-bit hashes, normally the ones the join's hash table
+// computes anyway, so a key is hashed once for both. The filter remixes them
+// under its own seed, so its blocks and bits don't follow the hash bits that
+// pick a table slot. The Value overloads hash with TypedValueHasher, so a
+// filter built from one table can be checked against rows from anywhere
+// (another table, a CSV scan).
+class BloomFilter {
+private:
+    static constexpr size_t WORDS_PER_BLOCK = 8;
+    static constexpr uint32_t SEED = 0x5bd1e995;
+
+    TrackedVector<uint32_t, MemoryComponent::HASH_TABLE> words_;
+    size_t blockCount_;
+
+    static uint64_t remix(uint64_t hash) { return hashInt64(static_cast<int64_t>(hash), SEED); }
+
+    // odd multipliers from the Parquet/Impala split-block filter; word i
+    // takes its bit from the top 5 bits of (hash * SALT[i])
+    static uint32_t bitFor(uint32_t hash, size_t word) {
+        static constexpr uint32_t SALT[WORDS_PER_BLOCK] = {
+            0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+            0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+        return 1u << ((hash * SALT[word]) >> 27);
+    }
+
+    // index of the first word of hash's block
+    size_t blockFor(uint64_t hash) const {
+        // the high half picks the block, the low half the bits within it
+        size_t block = static_cast<size_t>(((hash >> 32) * blockCount_) >> 32);
+        return block * WORDS_PER_BLOCK;
+    }
+
+public:
+    explicit BloomFilter(size_t expectedKeys, double bitsPerKey = 10.0);
+
+    // builds a filter holding every value of column; throws if it is missing
+    static BloomFilter forColumn(const Table& table, const std::string& column, double bitsPerKey = 10.0);
+
+    static uint64_t hash(const Value& key) { return TypedValueHasher()(key); }
+
+    void add(uint64_t hash) {
+        hash = remix(hash);
+        uint32_t* block = &words_[blockFor(hash)];
+        for (size_t i = 0; i < WORDS_PER_BLOCK; ++i) {
+            block[i] |= bitFor(static_cast<uint32_t>(hash), i);
+        }
+    }
+
+    // same as add(), but safe against other threads adding at the same time
+    void addConcurrent(uint64_t hash) {
+        hash = remix(hash);
+        uint32_t* block = &words_[blockFor(hash)];
+        for (size_t i = 0; i < WORDS_PER_BLOCK; ++i) {
+            __atomic_fetch_or(&block[i], bitFor(static_cast<uint32_t>(hash), i), __ATOMIC_RELAXED);
+        }
+    }
+
+    void add(const Value& key) { add(hash(key)); }
+
+    // false means key was never added; true may be a false positive
+    bool mayContain(uint64_t hash) const {
+        hash = remix(hash);
+        const uint32_t* block = &words_[blockFor(hash)];
+        bool present = true;
+        for (size_t i = 0; i < WORDS_PER_BLOCK; ++i) {
+            present &= (block[i] & bitFor(static_cast<uint32_t>(hash), i)) != 0;
+        }
+        return present;
+    }
+
+    bool mayContain(const Value& key) const { return mayContain(hash(key)); }
+
+    size_t memoryUsage() const { return blockCount_ * WORDS_PER_BLOCK * sizeof(uint32_t); }
+};
@@ -0,0 +1,15 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// CRC-32C (Castagnoli polynomial). On x86-64 the SSE4.2 crc32 instruction
+// is used when the CPU has it (checked once); elsewhere a table-driven loop.
+uint32_t crc32c(const void* data, size_t length, uint32_t crc = 0);
+
+// 64-bit hash built on CRC-32C: alternate 8-byte words feed two CRC lanes,
+// which run in parallel, and a murmur-style finalizer mixes the two. A lone
+// 64-bit key still carries only 32 bits of CRC state.
+uint64_t crc32cHash64(const void* data, size_t length, uint64_t seed);
+
+// true when crc32c() runs on the SSE4.2 instruction
+bool crc32cHardwareAvailable();
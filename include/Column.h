@@ -0,0 +1,224 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "BitPacking.h"
+#include "MemoryTracker.h"
+#include "Value.h"
+
+// Distinct strings of one or more dictionary-encoded columns, numbered
+// 0, 1, 2, ... in first-seen order. Columns holding codes from the same
+// dictionary compare equal exactly when their codes do.
+class StringDictionary {
+    private:
+        std::unordered_map<std::string, uint32_t, std::hash<std::string>, std::equal_to<std::string>,
+                           TrackingAllocator<std::pair<const std::string, uint32_t>, MemoryComponent::TABLE>> codes_;
+        TrackedVector<const std::string*, MemoryComponent::TABLE> strings_; // code -> key in codes_
+
+    public:
+        static constexpr uint32_t NO_CODE = UINT32_MAX;
+
+        // code of s, added if it is new
+        uint32_t intern(std::string_view s);
+        // code of s, or NO_CODE
+        uint32_t find(std::string_view s) const;
+        std::string_view at(uint32_t code) const { return *strings_[code]; }
+        size_t size() const { return strings_.size(); }
+        size_t memoryUsage() const;
+};
+
+// storage of an INTEGER column, see Column::compress
+enum class ColumnEncoding {
+    PLAIN,
+    BITPACKED,  // value - reference in bitWidth bits each
+    RLE         // (value, end row) per run of equal values
+};
+
+// One table column in a single typed array: INTEGER and DOUBLE values sit
+// in a contiguous int64_t/double vector, STRING values back to back in one
+// byte buffer with an offset per row. A validity bitmap (bit set = not
+// NULL) marks the NULLs, whose slot in the value array holds 0 or "".
+// A scan over one column reads dense memory and never touches the others.
+//
+// A STRING column can instead be dictionary-encoded: each row holds the
+// 32-bit code of its string in a StringDictionary (NO_CODE for NULL), and
+// the dictionary may be shared with other columns.
+//
+// A column can also borrow its arrays from memory it does not own, such as
+// a mapped snapshot file (see Table::openSnapshot). It is read in place,
+// and copies the arrays into its own vectors before the first change.
+//
+// An INTEGER column can be compressed (compress()): frame-of-reference bit
+// packing or run-length encoding replaces the int64_t array, and the values
+// are unpacked a block at a time by decodeInt64 or ColumnScanner. A change
+// to a compressed column decodes it back to a plain array first.
+class Column {
+    private:
+        // column storage is counted under MemoryComponent::TABLE
+        template<typename T>
+        using Array = TrackedVector<T, MemoryComponent::TABLE>;
+
+        DataType type_;
+        size_t size_ = 0;
+        size_t nullCount_ = 0;
+        Array<uint64_t> validity_;
+        Array<int64_t> ints_;       // INTEGER
+        Array<double> doubles_;     // DOUBLE
+        Array<uint64_t> offsets_;   // STRING: size + 1 entries
+        Array<char> bytes_;         // STRING
+        Array<uint32_t> codes_;     // dictionary-encoded STRING
+        std::shared_ptr<StringDictionary> dictionary_;
+
+        // compressed INTEGER
+        ColumnEncoding encoding_ = ColumnEncoding::PLAIN;
+        int64_t reference_ = 0;
+        unsigned bitWidth_ = 0;
+        Array<uint64_t> packed_;    // BITPACKED
+        Array<int64_t> runValues_;  // RLE
+        Array<uint32_t> runEnds_;   // RLE: exclusive end row per run
+
+        // what the accessors read: the vectors above, or the arrays of a
+        // borrowed column, kept alive by backing_
+        const uint64_t* validityData_ = nullptr;
+        const int64_t* intData_ = nullptr;
+        const double* doubleData_ = nullptr;
+        const uint64_t* offsetData_ = nullptr;
+        const char* byteData_ = nullptr;
+        const uint32_t* codeData_ = nullptr;
+        std::shared_ptr<const void> backing_;
+
+        void appendValidity(bool valid);
+        // points the accessors at the vectors
+        void syncPointers();
+        // before a change: copies borrowed arrays into the vectors and
+        // decodes a compressed column
+        void makeWritable();
+        int64_t encodedInt64At(size_t i) const;
+
+    public:
+        // a borrowed column's arrays; values holds int64_t, double, uint32_t
+        // codes, or for plain STRING the size + 1 offsets into bytes
+        struct Arrays {
+            const uint64_t* validity = nullptr;
+            const void* values = nullptr;
+            const char* bytes = nullptr;
+        };
+
+        explicit Column(DataType type);
+        // read-only view of arrays that backing keeps alive
+        static Column borrow(DataType type, size_t size, size_t nullCount, const Arrays& arrays,
+                             std::shared_ptr<const void> backing,
+                             std::shared_ptr<StringDictionary> dictionary = nullptr);
+
+        Column(const Column& other);
+        Column& operator=(const Column& other);
+        Column(Column&&) noexcept = default;
+        Column& operator=(Column&&) noexcept = default;
+
+        DataType type() const { return type_; }
+        size_t size() const { return size_; }
+        size_t nullCount() const { return nullCount_; }
+
+        // throws if the value is neither NULL nor of the column's type
+        void append(const Value& value);
+        void appendNull();
+        // appends row i of other, which must have the same type
+        void appendFrom(const Column& other, size_t i);
+        void reserve(size_t rows);
+
+        // re-stores a STRING column as codes into dictionary (strings it
+        // lacks are added; nullptr starts a new one); throws for other
+        // column types
+        void encodeDictionary(std::shared_ptr<StringDictionary> dictionary);
+        bool isDictionaryEncoded() const { return dictionary_ != nullptr; }
+        const std::shared_ptr<StringDictionary>& dictionary() const { return dictionary_; }
+
+        // re-stores an INTEGER column in the smallest of BITPACKED, RLE and
+        // PLAIN; other column types are left alone
+        void compress();
+        // back to a plain int64_t array
+        void decompress();
+        ColumnEncoding encoding() const { return encoding_; }
+        unsigned bitWidth() const { return bitWidth_; }
+        // values of INTEGER rows [begin, end) into out, a block at a time
+        // for a compressed column; NULL rows decode to an unspecified value
+        void decodeInt64(size_t begin, size_t end, int64_t* out) const;
+        const uint32_t* codeData() const { return codeData_; }
+        uint32_t codeAt(size_t i) const { return codeData_[i]; }
+
+        bool isValid(size_t i) const {
+            return (validityData_[i >> 6] >> (i & 63)) & 1;
+        }
+
+        // raw arrays; NULL rows hold 0 (NO_CODE for codes). int64Data is
+        // nullptr for a compressed column
+        const uint64_t* validityData() const { return validityData_; }
+        const int64_t* int64Data() const { return intData_; }
+        const double* doubleData() const { return doubleData_; }
+        // plain STRING: size + 1 offsets into the string bytes
+        const uint64_t* stringOffsets() const { return offsetData_; }
+        const char* stringBytes() const { return byteData_; }
+        bool isBorrowed() const { return backing_ != nullptr; }
+
+        int64_t int64At(size_t i) const {
+            return encoding_ == ColumnEncoding::PLAIN ? intData_[i] : encodedInt64At(i);
+        }
+        double doubleAt(size_t i) const { return doubleData_[i]; }
+        std::string_view stringAt(size_t i) const {
+            if (dictionary_) {
+                return codeData_[i] == StringDictionary::NO_CODE ? std::string_view() : dictionary_->at(codeData_[i]);
+            }
+            return std::string_view(byteData_ + offsetData_[i], offsetData_[i + 1] - offsetData_[i]);
+        }
+
+        // row i as a Value (NULL when not valid)
+        Value valueAt(size_t i) const;
+        // same, into an existing Value; a string reuses out's buffer
+        void loadValue(size_t i, Value& out) const;
+
+        // heap owned by the column; borrowed arrays are not counted
+        size_t memoryUsage() const;
+        void clear();
+};
+
+// Reads a column in row order. A compressed INTEGER column is unpacked
+// BLOCK_ROWS rows at a time, so a sequential scan runs the unpack kernel
+// once per block instead of decoding every row on its own. Not thread-safe;
+// use one scanner per thread.
+class ColumnScanner {
+    private:
+        const Column& column_;
+        TrackedVector<int64_t, MemoryComponent::JOIN> block_; // scans run while joining
+        size_t blockBegin_ = 0;
+        size_t blockEnd_ = 0;
+
+    public:
+        static constexpr size_t BLOCK_ROWS = 1024;
+
+        explicit ColumnScanner(const Column& column) : column_(column) {}
+
+        // same as column.loadValue(i, out)
+        void load(size_t i, Value& out) {
+            if (column_.encoding() == ColumnEncoding::PLAIN || !column_.isValid(i)) {
+                column_.loadValue(i, out);
+                return;
+            }
+            out.data = int64At(i);
+        }
+
+        // same as column.int64At(i), for an INTEGER column
+        int64_t int64At(size_t i) {
+            if (column_.encoding() == ColumnEncoding::PLAIN) return column_.int64Data()[i];
+            if (i < blockBegin_ || i >= blockEnd_) {
+                blockBegin_ = i - i % BLOCK_ROWS;
+                blockEnd_ = std::min(column_.size(), blockBegin_ + BLOCK_ROWS);
+                block_.resize(BLOCK_ROWS);
+                column_.decodeInt64(blockBegin_, blockEnd_, block_.data());
+            }
+            return block_[i - blockBegin_];
+        }
+};
@@ -0,0 +1,192 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "Arena.h"
+#include "CustomHashTable.h"
+
+// Chained hash table that many threads can insert into at once. Each insert
+// pushes a new node onto its bucket with a CAS on the head pointer, so
+// writers never block each other and lookups may run alongside them.
+//
+// The bucket array is sized once from the expected entry count and never
+// grows (chains just get longer if the estimate is low). Every worker
+// allocates its nodes from its own arena, so inserts never contend on the
+// allocator either. Keys are not merged: each insert is its own node.
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class ConcurrentHashTable {
+    private:
+        struct Node {
+            Key key;
+            size_t hash; // hasher_(key), compared before the key
+            Value value;
+            Node* next = nullptr;
+
+            Node(const Key& k, size_t h, const Value& v) : key(k), hash(h), value(v) {}
+        };
+
+        TrackedVector<std::atomic<Node*>, MemoryComponent::HASH_TABLE> buckets_;
+        size_t capacity_;
+        std::vector<Arena> arenas_; // one per worker; only that worker allocates from it
+        Hash hasher_;
+
+        // a walk over every chain; only meaningful once the build is done
+        DetailedHashTableStats walk(bool histograms) const {
+            DetailedHashTableStats detailed;
+            HashTableStats& stats = detailed.summary;
+            size_t distanceTotal = 0;
+            stats.totalBuckets = capacity_;
+            for (size_t i = 0; i < capacity_; ++i) {
+                size_t chainLength = 0;
+                for (const Node* node = buckets_[i].load(std::memory_order_acquire); node; node = node->next) {
+                    if (histograms) addHistogramSample(detailed.probeDistanceHistogram, chainLength);
+                    distanceTotal += chainLength;
+                    chainLength++;
+                }
+                if (histograms) addHistogramSample(detailed.chainLengthHistogram, chainLength);
+                if (chainLength == 0) continue;
+                stats.usedBuckets++;
+                stats.totalEntries += chainLength;
+                stats.collisions += chainLength - 1;
+                stats.maxChainLength = std::max(stats.maxChainLength, chainLength);
+            }
+            stats.loadFactor = static_cast<double>(stats.usedBuckets) / capacity_;
+            stats.avgChainLength = stats.usedBuckets > 0 ?
+                static_cast<double>(stats.totalEntries) / stats.usedBuckets : 0.0;
+            stats.avgProbeDistance = stats.totalEntries > 0 ?
+                static_cast<double>(distanceTotal) / stats.totalEntries : 0.0;
+            stats.maxProbeDistance = stats.maxChainLength > 0 ? stats.maxChainLength - 1 : 0;
+            stats.memoryUsage = sizeof(*this) + capacity_ * sizeof(std::atomic<Node*>);
+            for (const auto& arena : arenas_) stats.memoryUsage += arena.bytesReserved();
+            return detailed;
+        }
+
+        static void addHistogramSample(std::vector<size_t>& histogram, size_t sample) {
+            if (histogram.size() <= sample) histogram.resize(sample + 1, 0);
+            histogram[sample]++;
+        }
+
+    public:
+        ConcurrentHashTable(size_t expectedEntries, size_t workers, Hash hasher = Hash())
+            : buckets_(std::max<size_t>(expectedEntries, 1)),
+              capacity_(std::max<size_t>(expectedEntries, 1)),
+              arenas_(std::max<size_t>(workers, 1)),
+              hasher_(std::move(hasher)) {
+            for (size_t i = 0; i < capacity_; ++i) {
+                buckets_[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        ~ConcurrentHashTable() {
+            if (std::is_trivially_destructible<Key>::value) return;
+            for (size_t i = 0; i < capacity_; ++i) {
+                for (Node* node = buckets_[i].load(std::memory_order_relaxed); node; ) {
+                    Node* next = node->next;
+                    node->~Node();
+                    node = next;
+                }
+            }
+        }
+
+        ConcurrentHashTable(const ConcurrentHashTable&) = delete;
+        ConcurrentHashTable& operator=(const ConcurrentHashTable&) = delete;
+
+        size_t workers() const { return arenas_.size(); }
+
+        // safe to call from several threads at once as long as each passes
+        // its own worker index
+        void insert(const Key& key, const Value& value, size_t worker) {
+            insertHashed(key, hasher_(key), value, worker);
+        }
+
+        // insert with h = hashOf(key) already computed
+        void insertHashed(const Key& key, size_t h, const Value& value, size_t worker) {
+            Node* node = arenas_[worker].create<Node>(key, h, value);
+            std::atomic<Node*>& head = buckets_[h % capacity_];
+            node->next = head.load(std::memory_order_relaxed);
+            // release publishes the node's contents to whoever loads the new head
+            while (!head.compare_exchange_weak(node->next, node,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+            }
+        }
+
+        // inserts (keyOf(i), i) for every i < rowCount, splitting the range
+        // over the table's workers. keyOf is called once per row, on the
+        // worker thread that inserts it; so is rowHashed(i, hashOf(keyOf(i))).
+        template<typename KeyOf, typename RowHashed>
+        void insertRows(size_t rowCount, KeyOf keyOf, RowHashed rowHashed) {
+            size_t threads = std::min(workers(), std::max<size_t>(rowCount, 1));
+            size_t chunk = (rowCount + threads - 1) / threads;
+            auto insertRange = [this, &keyOf, &rowHashed](size_t begin, size_t end, size_t worker) {
+                for (size_t i = begin; i < end; ++i) {
+                    const Key& key = keyOf(i);
+                    size_t h = hasher_(key);
+                    rowHashed(i, h);
+                    insertHashed(key, h, i, worker);
+                }
+            };
+            std::vector<std::thread> pool;
+            for (size_t worker = 1; worker < threads; ++worker) {
+                pool.emplace_back([&insertRange, worker, chunk, rowCount] {
+                    insertRange(std::min(rowCount, worker * chunk), std::min(rowCount, (worker + 1) * chunk), worker);
+                });
+            }
+            // the calling thread takes the first chunk
+            insertRange(0, std::min(rowCount, chunk), 0);
+            for (auto& thread : pool) thread.join();
+        }
+
+        template<typename KeyOf>
+        void insertRows(size_t rowCount, KeyOf keyOf) {
+            insertRows(rowCount, std::move(keyOf), [](size_t, size_t) {});
+        }
+
+        // same contracts as the CustomHashTable lookups of the same name
+        template<typename Callback>
+        size_t forEachMatch(const Key& key, Callback&& callback) const {
+            return forEachMatchHashed(key, hashOf(key), callback);
+        }
+
+        size_t hashOf(const Key& key) const {
+            return hasher_(key);
+        }
+
+        void hashOfBatch(const Key* const* keys, size_t count, size_t* out) const {
+            hashKeys(hasher_, keys, count, out);
+        }
+
+        void prefetchBucket(size_t h) const {
+            __builtin_prefetch(&buckets_[h % capacity_]);
+        }
+
+        void prefetchEntry(size_t h) const {
+            const Node* node = buckets_[h % capacity_].load(std::memory_order_acquire);
+            if (node) __builtin_prefetch(node);
+        }
+
+        template<typename Callback>
+        size_t forEachMatchHashed(const Key& key, size_t h, Callback&& callback) const {
+            size_t matches = 0;
+            const Node* node = buckets_[h % capacity_].load(std::memory_order_acquire);
+            for (; node; node = node->next) {
+                if (node->hash == h && node->key == key) {
+                    callback(node->value);
+                    matches++;
+                }
+            }
+            return matches;
+        }
+
+        bool contains(const Key& key) const {
+            return forEachMatch(key, [](const Value&) {}) > 0;
+        }
+
+        // computed by walking the table, so call it after the build
+        HashTableStats getStats() const { return walk(false).summary; }
+
+        DetailedHashTableStats computeDetailedStats() const { return walk(true); }
+};
@@ -0,0 +1,123 @@
+#pragma once
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "CustomHashTable.h"
+
+// Build-once multimap from keys to row ids in CSR (compressed sparse row)
+// form. The first pass gives every distinct key a slot in a CustomHashTable
+// and counts its rows; the second lays all row ids out in one array, grouped
+// by key, with slot s owning rowIds_[offsets_[s], offsets_[s + 1]). Nothing
+// grows while rows are placed, and a probe reads one contiguous range.
+// StrategyPolicy is passed on to the key table (see CustomHashTable).
+template<typename Key, typename Hash = std::hash<Key>, typename StrategyPolicy = RuntimeStrategy>
+class CsrHashTable {
+    private:
+        // keys are unique and only looked up once the build is done
+        using SlotTable = CustomHashTable<Key, uint32_t, Hash, StrategyPolicy, BulkGrowth, UniqueValuePayload>;
+
+        using Array = TrackedVector<uint32_t, MemoryComponent::HASH_TABLE>;
+
+        SlotTable slots_; // distinct key -> slot
+        Array offsets_;              // slot count + 1 entries
+        Array rowIds_;
+
+        static constexpr size_t INITIAL_KEY_CAPACITY = 1024;
+
+        template<typename Callback>
+        size_t emitRange(uint32_t slot, Callback& callback) const {
+            for (uint32_t i = offsets_[slot]; i < offsets_[slot + 1]; ++i) {
+                callback(static_cast<size_t>(rowIds_[i]));
+            }
+            return offsets_[slot + 1] - offsets_[slot];
+        }
+
+    public:
+        // altHasher is only used by the CUCKOO strategy, as in CustomHashTable
+        CsrHashTable(CollisionStrategy strategy, Hash hasher = Hash(), Hash altHasher = Hash())
+            : slots_(SlotTable::capacityFor(INITIAL_KEY_CAPACITY),
+                     strategy, std::move(hasher), std::move(altHasher)) {}
+
+        // indexes (keyOf(i), i) for every i < rowCount. keyOf is called once
+        // per row, during the first pass; so is rowHashed(i, hashOf(keyOf(i))).
+        template<typename KeyOf, typename RowHashed>
+        void build(size_t rowCount, KeyOf keyOf, RowHashed rowHashed) {
+            if (rowCount >= UINT32_MAX) {
+                throw std::runtime_error("CSR build supports fewer than 2^32 rows");
+            }
+
+            // pass 1: slot per row, and rows per slot (kept in offsets_[slot + 1])
+            Array rowSlots(rowCount);
+            offsets_.assign(1, 0);
+            for (size_t i = 0; i < rowCount; ++i) {
+                const Key& key = keyOf(i);
+                size_t h = slots_.hashOf(key);
+                rowHashed(i, h);
+                uint32_t slot = 0;
+                if (slots_.forEachMatchHashed(key, h, [&slot](uint32_t found) { slot = found; }) == 0) {
+                    slot = static_cast<uint32_t>(offsets_.size() - 1);
+                    slots_.insertHashed(key, h, slot);
+                    offsets_.push_back(0);
+                }
+                offsets_[slot + 1]++;
+                rowSlots[i] = slot;
+            }
+
+            // counts -> start offsets
+            for (size_t slot = 1; slot < offsets_.size(); ++slot) {
+                offsets_[slot] += offsets_[slot - 1];
+            }
+
+            // pass 2: scatter row ids; row order within a key is preserved
+            rowIds_.resize(rowCount);
+            Array cursor(offsets_.begin(), offsets_.end() - 1);
+            for (size_t i = 0; i < rowCount; ++i) {
+                rowIds_[cursor[rowSlots[i]]++] = static_cast<uint32_t>(i);
+            }
+        }
+
+        template<typename KeyOf>
+        void build(size_t rowCount, KeyOf keyOf) {
+            build(rowCount, std::move(keyOf), [](size_t, size_t) {});
+        }
+
+        // lookup interface matches CustomHashTable's
+        template<typename Callback>
+        size_t forEachMatch(const Key& key, Callback&& callback) const {
+            return forEachMatchHashed(key, hashOf(key), callback);
+        }
+
+        size_t hashOf(const Key& key) const { return slots_.hashOf(key); }
+        void hashOfBatch(const Key* const* keys, size_t count, size_t* out) const {
+            slots_.hashOfBatch(keys, count, out);
+        }
+        void prefetchBucket(size_t h) const { slots_.prefetchBucket(h); }
+        void prefetchEntry(size_t h) const { slots_.prefetchEntry(h); }
+
+        template<typename Callback>
+        size_t forEachMatchHashed(const Key& key, size_t h, Callback&& callback) const {
+            size_t matches = 0;
+            slots_.forEachMatchHashed(key, h, [&](uint32_t slot) { matches += emitRange(slot, callback); });
+            return matches;
+        }
+
+        bool contains(const Key& key) const {
+            return slots_.contains(key);
+        }
+
+        size_t distinctKeys() const { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+        size_t size() const { return rowIds_.size(); }
+
+        // key table stats; memory also counts the offset and row id arrays
+        HashTableStats getStats() const {
+            HashTableStats stats = slots_.getStats();
+            stats.memoryUsage += (offsets_.capacity() + rowIds_.capacity()) * sizeof(uint32_t);
+            return stats;
+        }
+
+        DetailedHashTableStats computeDetailedStats() const {
+            DetailedHashTableStats detailed = slots_.computeDetailedStats();
+            detailed.summary = getStats();
+            return detailed;
+        }
+};
@@ -3,12 +3,34 @@
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <limits>
+#include <cstdint>
+#include <type_traits>
+#include "Arena.h"
+#include "MemoryTracker.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 enum class CollisionStrategy {
     CHAINING,
-    LINEAR_PROBING
+    LINEAR_PROBING,
+    SWISS, // flat open addressing with SIMD-matched control bytes
+    ROBIN_HOOD, // linear probing that keeps probe distances balanced
+    CUCKOO // two hashes, 4-way buckets and a stash: two buckets plus the stash per lookup
 };
 
+inline const char* collisionStrategyName(CollisionStrategy strategy) {
+    switch (strategy) {
+        case CollisionStrategy::CHAINING: return "Chaining";
+        case CollisionStrategy::LINEAR_PROBING: return "Linear Probing";
+        case CollisionStrategy::SWISS: return "Swiss Table";
+        case CollisionStrategy::ROBIN_HOOD: return "Robin Hood";
+        case CollisionStrategy::CUCKOO: return "Cuckoo";
+    }
+    return "Unknown";
+}
+
 struct HashTableStats {
     size_t totalBuckets = 0;
     size_t usedBuckets = 0;
@@ -18,168 +40,1477 @@ struct HashTableStats {
     double avgChainLength = 0.0;
     size_t maxChainLength = 0;
     size_t memoryUsage = 0;
+    size_t resizes = 0;
+    // distance of each entry from where its probe starts: nodes ahead of it
+    // in the chain, or slots (groups for SWISS) past its home position.
+    // CUCKOO counts 0 for the primary bucket, 1 for the secondary, 2 for the stash.
+    // The max is a high-water mark and does not shrink on erase.
+    double avgProbeDistance = 0.0;
+    size_t maxProbeDistance = 0;
+};
+
+// out[i] = hasher(*keys[i]), through the hasher's own hashBatch() when it
+// has one (e.g. TypedValueHasher), otherwise one call per key
+template<typename Hash, typename Key, typename = void>
+struct HasBatchHash : std::false_type {};
+
+template<typename Hash, typename Key>
+struct HasBatchHash<Hash, Key, std::void_t<decltype(std::declval<const Hash&>().hashBatch(
+    std::declval<const Key* const*>(), size_t{}, std::declval<size_t*>()))>> : std::true_type {};
+
+template<typename Hash, typename Key>
+void hashKeys(const Hash& hasher, const Key* const* keys, size_t count, size_t* out) {
+    if constexpr (HasBatchHash<Hash, Key>::value) {
+        hasher.hashBatch(keys, count, out);
+    } else {
+        for (size_t i = 0; i < count; ++i) out[i] = hasher(*keys[i]);
+    }
+}
+
+// full distributions; walks the whole table, so only computed on request
+struct DetailedHashTableStats {
+    HashTableStats summary;
+    // [length] -> number of buckets; for open addressing a "chain" is a run of
+    // occupied slots (a cluster), for SWISS it is the occupancy of a group
+    std::vector<size_t> chainLengthHistogram;
+    // [distance] -> number of entries; nodes walked in a chain, slots from the
+    // home slot (linear probing, Robin Hood), groups from the home group (SWISS)
+    // or 0/1/2 for primary bucket/secondary bucket/stash (CUCKOO)
+    std::vector<size_t> probeDistanceHistogram;
+};
+
+// Table policies, given as template parameters of CustomHashTable. A table
+// built from fixed policies compiles to code specialized for them; the
+// defaults keep the per-instance, run-time behaviour.
+
+// Collision strategy. RuntimeStrategy takes it from the constructor and
+// branches on it in every operation; FixedStrategy<S> makes it a constant,
+// so the branches for the other strategies fold away.
+struct RuntimeStrategy {
+    static constexpr CollisionStrategy resolve(CollisionStrategy requested) { return requested; }
+};
+
+template<CollisionStrategy S>
+struct FixedStrategy {
+    static constexpr CollisionStrategy resolve(CollisionStrategy) { return S; }
 };
 
-template<typename Key, typename Value, typename Hash = std::hash<Key>>
+// Growth. IncrementalGrowth moves a few old buckets per insert after a
+// resize, so no single insert pays for the whole rehash, and lookups check
+// both tables until the old one drains. BulkGrowth rehashes everything
+// inside the resize: cheaper in total, and lookups only ever see one table.
+struct IncrementalGrowth {
+    static constexpr bool INCREMENTAL = true;
+};
+
+struct BulkGrowth {
+    static constexpr bool INCREMENTAL = false;
+};
+
+// Payload layout. MultiValuePayload keeps every value inserted under a key:
+// the first inline, more in an arena array that doubles as it grows
+// (outgrown arrays stay in the arena until clear()). UniqueValuePayload
+// keeps one value per key in place; inserting an existing key replaces it.
+struct MultiValuePayload {
+    static constexpr bool UNIQUE = false;
+
+    template<typename Value>
+    struct List {
+        Value first{};
+        Value* spill = nullptr;
+        uint32_t count = 0;
+        uint32_t capacity = 1;
+
+        const Value* begin() const { return spill ? spill : &first; }
+        const Value* end() const { return begin() + count; }
+        size_t size() const { return count; }
+    };
+
+    template<typename Value>
+    static void push(List<Value>& list, const Value& value, Arena& arena) {
+        if (list.count == 0) {
+            list.first = value;
+            list.count = 1;
+            return;
+        }
+        if (list.count == list.capacity) {
+            Value* grown = arena.allocateArray<Value>(list.capacity * 2);
+            std::copy(list.begin(), list.end(), grown);
+            list.spill = grown;
+            list.capacity *= 2;
+        }
+        list.spill[list.count++] = value;
+    }
+
+    template<typename Value>
+    static size_t spilledBytes(const List<Value>& list) {
+        return list.spill ? list.capacity * sizeof(Value) : 0;
+    }
+};
+
+struct UniqueValuePayload {
+    static constexpr bool UNIQUE = true;
+
+    template<typename Value>
+    struct List {
+        Value value{};
+
+        const Value* begin() const { return &value; }
+        const Value* end() const { return &value + 1; }
+        size_t size() const { return 1; }
+    };
+
+    template<typename Value>
+    static void push(List<Value>& list, const Value& value, Arena&) {
+        list.value = value;
+    }
+
+    template<typename Value>
+    static size_t spilledBytes(const List<Value>&) {
+        return 0;
+    }
+};
+
+// Run-time strategy to compile-time policy: calls fn(FixedStrategy<S>{})
+// for the S equal to strategy. Lets callers that choose the strategy at run
+// time (JoinEngine, the benchmarks) still build specialized tables.
+template<typename Fn>
+decltype(auto) dispatchStrategy(CollisionStrategy strategy, Fn&& fn) {
+    switch (strategy) {
+        case CollisionStrategy::LINEAR_PROBING: return fn(FixedStrategy<CollisionStrategy::LINEAR_PROBING>{});
+        case CollisionStrategy::SWISS: return fn(FixedStrategy<CollisionStrategy::SWISS>{});
+        case CollisionStrategy::ROBIN_HOOD: return fn(FixedStrategy<CollisionStrategy::ROBIN_HOOD>{});
+        case CollisionStrategy::CUCKOO: return fn(FixedStrategy<CollisionStrategy::CUCKOO>{});
+        case CollisionStrategy::CHAINING: break;
+    }
+    return fn(FixedStrategy<CollisionStrategy::CHAINING>{});
+}
+
+template<typename Key, typename Value, typename Hash = std::hash<Key>,
+         typename StrategyPolicy = RuntimeStrategy,
+         typename GrowthPolicy = IncrementalGrowth,
+         typename PayloadPolicy = MultiValuePayload>
 class CustomHashTable {
     private:
+        // value lists are raw arena memory that is copied around and never
+        // destroyed, so the payload has to be plain data (row ids)
+        static_assert(std::is_trivially_copyable<Value>::value,
+                      "CustomHashTable payloads must be trivially copyable");
+
+        // values stored under one key, laid out by PayloadPolicy
+        using ValueList = typename PayloadPolicy::template List<Value>;
+
+        // chain/probe node, allocated from arena_. Only the key's destructor
+        // is ever run (destroyEntry); the memory goes back in clear().
+        //
+        // Every layout keeps the full hasher_ output next to the key: lookups
+        // compare it before the key, so a mismatch rarely costs a key compare
+        // (a string compare for string keys), and growth moves entries without
+        // calling the hasher again.
         struct Entry {
             Key key;
-            std::vector<Value> values; // support for non-unique keys
-            std::unique_ptr<Entry> next; // for chaining
-            bool occupied = false; // for linear probing
+            size_t hash; // hasher_(key)
+            ValueList values;
+            Entry* next = nullptr; // for chaining
 
-            Entry() = default;
-            Entry(const Key& k, const Value& v) : key(k), occupied(true) {
-                values.push_back(v);
+            Entry(const Key& k, size_t h) : key(k), hash(h) {}
+        };
+
+        // table storage is counted under MemoryComponent::HASH_TABLE
+        template<typename T>
+        using Array = TrackedVector<T, MemoryComponent::HASH_TABLE>;
+
+        using Buckets = Array<Entry*>;
+
+        // SWISS layout: one control byte per slot (CTRL_EMPTY, CTRL_DELETED or
+        // the 7-bit H2 fragment of the hash), keys and values stored inline in
+        // flat arrays. Slots are grouped in GROUP_WIDTH so a whole group is
+        // matched at once.
+        struct SwissSlots {
+            Array<int8_t> ctrl;
+            Array<Key> keys;
+            Array<size_t> hashes; // mixHash(hasher_(key)) per slot
+            Array<Value> values;
+            size_t groupMask = 0;
+
+            size_t bytes() const {
+                return ctrl.capacity() * sizeof(int8_t) + keys.capacity() * sizeof(Key) +
+                       hashes.capacity() * sizeof(size_t) + values.capacity() * sizeof(Value);
             }
         };
 
-        std::vector<std::unique_ptr<Entry>> table_;
+        static constexpr size_t GROUP_WIDTH = 16;
+        static constexpr int8_t CTRL_EMPTY = -128;
+        static constexpr int8_t CTRL_DELETED = -2; // erased, or migrated to the new table
+
+        // ROBIN_HOOD layout: flat slots over a power-of-two capacity. An insert
+        // that has probed further than a resident entry takes its slot, so a
+        // lookup can stop as soon as it is further from home than the slot it
+        // is looking at.
+        struct RobinHoodSlot {
+            Key key;
+            size_t hash = 0; // hasher_(key)
+            ValueList values;
+            uint32_t distance = 0; // probe distance + 1; 0 marks an empty slot
+        };
+
+        using RobinHoodSlots = Array<RobinHoodSlot>;
+
+        // CUCKOO layout: a key lives in one of two CUCKOO_WAYS-slot buckets chosen
+        // by two independent hashes, or in a small stash when the kick-out walk
+        // fails. 1-byte tags are kept apart from the entries, so a lookup reads
+        // two 4-byte tag words and touches entries only on a tag match.
+        struct CuckooEntry {
+            Key key;
+            size_t hash = 0;    // hasher_(key)
+            size_t altHash = 0; // altHasher_(key)
+            ValueList values;
+        };
+
+        struct CuckooBuckets {
+            Array<uint8_t> tags; // 0 marks an empty slot
+            Array<CuckooEntry> slots;
+            Array<CuckooEntry> stash;
+            size_t bucketMask = 0;
+
+            bool empty() const { return tags.empty(); }
+
+            size_t bytes() const {
+                return tags.capacity() * sizeof(uint8_t) +
+                       (slots.capacity() + stash.capacity()) * sizeof(CuckooEntry);
+            }
+        };
+
+        struct CuckooHashes {
+            size_t hash; // hasher_(key), compared before the key
+            size_t primary;
+            size_t secondary;
+            uint8_t tag;
+        };
+
+        static constexpr size_t CUCKOO_WAYS = 4;
+        static constexpr size_t CUCKOO_MAX_KICKS = 256;
+        static constexpr size_t CUCKOO_STASH_LIMIT = 8;
+        static constexpr size_t CUCKOO_NOT_FOUND = static_cast<size_t>(-1);
+
+        Buckets table_;
+        SwissSlots swiss_;
+        RobinHoodSlots robin_;
+        CuckooBuckets cuckoo_;
         size_t size_;
         size_t capacity_;
         CollisionStrategy strategy_;
         Hash hasher_;
-        HashTableStats stats_;
+        Hash altHasher_; // second, independent hash for CUCKOO
+        size_t cuckooKicks_ = 0; // rotates the slot picked as kick-out victim
+        // stash size that triggers growth: CUCKOO_STASH_LIMIT, or no limit
+        // while the stash holds keys that growing does not place
+        size_t cuckooStashLimit_ = CUCKOO_STASH_LIMIT;
+        mutable HashTableStats stats_; // derived ratios are filled in by getStats()
+        Arena arena_;                  // chain/probe entries and spilled value lists
+        size_t swissTombstones_ = 0;   // erased SWISS slots, still counted toward load
+        size_t probeDistanceTotal_ = 0;
+        size_t probeSamples_ = 0;
 
         static constexpr double LOAD_FACTOR_THRESHOLD = 0.75;
+        static constexpr double SWISS_LOAD_FACTOR_THRESHOLD = 0.875;
+        static constexpr double CUCKOO_LOAD_FACTOR_THRESHOLD = 0.9;
+
+        // Growth is incremental: resize() swaps in a table of twice the size and
+        // keeps the old one around. Every later insert moves a few old buckets
+        // (whole clusters for linear probing, whole groups for SWISS) across, and
+        // lookups consult both tables until the old one is drained.
+        static constexpr size_t MIGRATION_BUCKETS_PER_OP = 4;
+        Buckets oldTable_;
+        SwissSlots oldSwiss_;
+        RobinHoodSlots oldRobin_;
+        CuckooBuckets oldCuckoo_;
+        size_t oldCapacity_ = 0;
+        size_t migrateStart_ = 0;  // linear probing/Robin Hood: an empty slot, so steps align to clusters
+        size_t migrateCursor_ = 0; // old buckets/groups migrated so far
+
+        // never true between operations under BulkGrowth, and then known so
+        // at compile time
+        bool migrating() const { return GrowthPolicy::INCREMENTAL && oldCapacity_ > 0; }
+
+        CollisionStrategy strategy() const { return StrategyPolicy::resolve(strategy_); }
+
+        void initStorage() {
+            if (strategy() == CollisionStrategy::SWISS) {
+                initSwiss(swiss_, capacity_);
+                capacity_ = swiss_.ctrl.size();
+            } else if (strategy() == CollisionStrategy::ROBIN_HOOD) {
+                initRobin(robin_, capacity_);
+                capacity_ = robin_.size();
+            } else if (strategy() == CollisionStrategy::CUCKOO) {
+                initCuckoo(cuckoo_, capacity_);
+                capacity_ = cuckoo_.slots.size();
+            } else {
+                table_.resize(capacity_);
+            }
+            resetStats();
+        }
+
+        // counters are kept current on every insert; this resets them to the
+        // empty-table state. Memory is derived from array capacities and the
+        // arena when the stats are read.
+        void resetStats() {
+            size_t resizes = stats_.resizes;
+            stats_ = HashTableStats{};
+            stats_.totalBuckets = capacity_;
+            stats_.resizes = resizes;
+            probeDistanceTotal_ = 0;
+            probeSamples_ = 0;
+        }
+
+        void recordChainLength(size_t chainLength) {
+            if (chainLength > 1) stats_.collisions++;
+            stats_.maxChainLength = std::max(stats_.maxChainLength, chainLength);
+        }
+
+        void recordProbeDistance(size_t distance) {
+            probeDistanceTotal_ += distance;
+            probeSamples_++;
+            stats_.maxProbeDistance = std::max(stats_.maxProbeDistance, distance);
+        }
+
+        void forgetProbeDistance(size_t distance) {
+            probeDistanceTotal_ -= distance;
+            probeSamples_--;
+        }
+
+        void addHistogramSample(std::vector<size_t>& histogram, size_t sample) const {
+            if (histogram.size() <= sample) histogram.resize(sample + 1, 0);
+            histogram[sample]++;
+        }
+
+        void pushValue(ValueList& list, const Value& value) {
+            PayloadPolicy::push(list, value, arena_);
+        }
+
+        void appendValues(ValueList& list, const ValueList& other) {
+            for (const auto& value : other) pushValue(list, value);
+        }
+
+        static size_t spilledBytes(const ValueList& list) {
+            return PayloadPolicy::spilledBytes(list);
+        }
+
+        ValueList singleValue(const Value& value) {
+            ValueList list;
+            pushValue(list, value);
+            return list;
+        }
+
+        Entry* newEntry(const Key& key, size_t h, const Value& value) {
+            Entry* entry = arena_.create<Entry>(key, h);
+            entry->values = singleValue(value);
+            return entry;
+        }
+
+        static void destroyEntry(Entry* entry) {
+            if (!std::is_trivially_destructible<Key>::value) entry->~Entry();
+        }
+
+        // runs the key destructors; with trivially destructible keys there is
+        // nothing to do and the whole walk is skipped
+        static void destroyEntries(Buckets& table) {
+            if (std::is_trivially_destructible<Key>::value) return;
+            for (Entry* bucket : table) {
+                while (bucket) {
+                    Entry* next = bucket->next;
+                    destroyEntry(bucket);
+                    bucket = next;
+                }
+            }
+        }
 
-        void resize();
-        size_t hash(const Key& key) const {
-            return hasher_(key) % capacity_;
+        static bool entryMatches(const Entry* entry, const Key& key, size_t h) {
+            return entry->hash == h && entry->key == key;
         }
-        size_t linearProbe(size_t startPos, const Key& key) const {
+
+        // first slot from startPos that is empty or holds key; h is hasher_(key)
+        static size_t linearProbe(const Buckets& table, size_t startPos, const Key& key, size_t h) {
+            size_t capacity = table.size();
             size_t currentPos = startPos;
-            for (size_t i = 0; i < capacity_; ++i) {
-                currentPos = (startPos + i) % capacity_;
-                if (!table_[currentPos] || table_[currentPos]->key == key) {
+            for (size_t i = 0; i < capacity; ++i) {
+                if (!table[currentPos] || entryMatches(table[currentPos], key, h)) {
                     return currentPos;
                 }
+                if (++currentPos == capacity) currentPos = 0;
+            }
+            return capacity; // Table is full
+        }
+
+        // finalizer from MurmurHash3, so weak hashers (std::hash on integers is
+        // the identity) still spread over both the group index and the tag
+        static size_t mixHash(size_t h) {
+            uint64_t x = h;
+            x ^= x >> 33;
+            x *= 0xff51afd7ed558ccdULL;
+            x ^= x >> 33;
+            x *= 0xc4ceb9fe1a85ec53ULL;
+            x ^= x >> 33;
+            return static_cast<size_t>(x);
+        }
+
+        static int8_t h2(size_t h) { return static_cast<int8_t>(h & 0x7F); }
+        static size_t h1(size_t h, size_t groupMask) { return (h >> 7) & groupMask; }
+
+        // bit i of the result is set when ctrl byte i of the group equals tag
+        static uint32_t matchGroup(const int8_t* group, int8_t tag) {
+#if defined(__SSE2__)
+            __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(tag))));
+#else
+            uint32_t mask = 0;
+            for (size_t i = 0; i < GROUP_WIDTH; ++i) {
+                if (group[i] == tag) mask |= (1u << i);
+            }
+            return mask;
+#endif
+        }
+
+        static size_t lowestBit(uint32_t mask) {
+            return static_cast<size_t>(__builtin_ctz(mask));
+        }
+
+        static void initSwiss(SwissSlots& slots, size_t requestedSlots) {
+            size_t groups = 1;
+            while (groups * GROUP_WIDTH < requestedSlots) {
+                groups <<= 1;
+            }
+            slots.groupMask = groups - 1;
+            slots.ctrl.assign(groups * GROUP_WIDTH, CTRL_EMPTY);
+            slots.keys.assign(groups * GROUP_WIDTH, Key{});
+            slots.hashes.assign(groups * GROUP_WIDTH, 0);
+            slots.values.assign(groups * GROUP_WIDTH, Value{});
+        }
+
+        // triangular probing over power-of-two group counts visits every group
+        void swissPlace(size_t h, const Key& key, const Value& value) {
+            size_t group = h1(h, swiss_.groupMask);
+            for (size_t probe = 0; probe <= swiss_.groupMask; ++probe) {
+                uint32_t empties = matchGroup(&swiss_.ctrl[group * GROUP_WIDTH], CTRL_EMPTY);
+                if (empties) {
+                    size_t slot = group * GROUP_WIDTH + lowestBit(empties);
+                    swiss_.ctrl[slot] = h2(h);
+                    swiss_.keys[slot] = key;
+                    swiss_.hashes[slot] = h;
+                    swiss_.values[slot] = value;
+                    recordChainLength(probe + 1);
+                    recordProbeDistance(probe);
+                    stats_.usedBuckets++;
+                    return;
+                }
+                group = (group + probe + 1) & swiss_.groupMask;
+            }
+        }
+
+        template<typename Callback>
+        static size_t swissFind(const SwissSlots& slots, size_t h, const Key& key, Callback& callback) {
+            size_t matches = 0;
+            int8_t tag = h2(h);
+            size_t group = h1(h, slots.groupMask);
+            for (size_t probe = 0; probe <= slots.groupMask; ++probe) {
+                const int8_t* ctrl = &slots.ctrl[group * GROUP_WIDTH];
+                uint32_t candidates = matchGroup(ctrl, tag);
+                while (candidates) {
+                    size_t slot = group * GROUP_WIDTH + lowestBit(candidates);
+                    if (slots.hashes[slot] == h && slots.keys[slot] == key) {
+                        callback(slots.values[slot]);
+                        matches++;
+                    }
+                    candidates &= candidates - 1;
+                }
+                // an empty slot means the key was never pushed past this group
+                if (matchGroup(ctrl, CTRL_EMPTY)) {
+                    break;
+                }
+                group = (group + probe + 1) & slots.groupMask;
+            }
+            return matches;
+        }
+
+        // index of one slot holding key, or slots.ctrl.size() if none does
+        static size_t swissSlotOf(const SwissSlots& slots, size_t h, const Key& key) {
+            int8_t tag = h2(h);
+            size_t group = h1(h, slots.groupMask);
+            for (size_t probe = 0; probe <= slots.groupMask; ++probe) {
+                const int8_t* ctrl = &slots.ctrl[group * GROUP_WIDTH];
+                for (uint32_t candidates = matchGroup(ctrl, tag); candidates; candidates &= candidates - 1) {
+                    size_t slot = group * GROUP_WIDTH + lowestBit(candidates);
+                    if (slots.hashes[slot] == h && slots.keys[slot] == key) {
+                        return slot;
+                    }
+                }
+                if (matchGroup(ctrl, CTRL_EMPTY)) {
+                    break;
+                }
+                group = (group + probe + 1) & slots.groupMask;
+            }
+            return slots.ctrl.size();
+        }
+
+        // UniqueValuePayload: SWISS and CHAINING place every insert in a new
+        // slot/node, so an existing key is looked for first and its value
+        // replaced. Return false when the key is not in that table.
+        bool swissAssign(SwissSlots& slots, size_t mixed, const Key& key, const Value& value) {
+            size_t slot = swissSlotOf(slots, mixed, key);
+            if (slot == slots.ctrl.size()) return false;
+            slots.values[slot] = value;
+            return true;
+        }
+
+        bool chainAssign(Buckets& table, size_t h, const Key& key, const Value& value) {
+            for (Entry* entry = table[h % table.size()]; entry; entry = entry->next) {
+                if (entryMatches(entry, key, h)) {
+                    pushValue(entry->values, value);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // UniqueValuePayload while migrating: a key still in the old table is
+        // updated there, otherwise it would be stored twice and migration
+        // would bring the stale value back
+        bool assignInOld(size_t h, const Key& key, const Value& value) {
+            if (strategy() == CollisionStrategy::SWISS) {
+                return swissAssign(oldSwiss_, mixHash(h), key, value);
+            }
+            if (strategy() == CollisionStrategy::CUCKOO) {
+                size_t pos = cuckooLocate(oldCuckoo_, key, cuckooHashes(key, h, oldCuckoo_.bucketMask));
+                if (pos == CUCKOO_NOT_FOUND) return false;
+                pushValue(cuckooEntryAt(oldCuckoo_, pos).values, value);
+                return true;
+            }
+            if (strategy() == CollisionStrategy::ROBIN_HOOD) {
+                size_t pos = robinFind(oldRobin_, key, h);
+                if (pos == oldRobin_.size()) return false;
+                pushValue(oldRobin_[pos].values, value);
+                return true;
+            }
+            if (strategy() == CollisionStrategy::CHAINING) {
+                return chainAssign(oldTable_, h, key, value);
+            }
+            size_t pos = linearProbe(oldTable_, h % oldTable_.size(), key, h);
+            if (pos == oldTable_.size() || !oldTable_[pos]) return false;
+            pushValue(oldTable_[pos]->values, value);
+            return true;
+        }
+
+        // appends an existing node to the tail of its chain in table_
+        void placeChainEntry(Entry* entry) {
+            size_t index = entry->hash % capacity_;
+            if (!table_[index]) {
+                table_[index] = entry;
+                stats_.usedBuckets++;
+                recordChainLength(1);
+                recordProbeDistance(0);
+                return;
+            }
+            size_t chainLength = 2;
+            Entry* current = table_[index];
+            while (current->next) {
+                current = current->next;
+                chainLength++;
+            }
+            current->next = entry;
+            recordChainLength(chainLength);
+            recordProbeDistance(chainLength - 1);
+        }
+
+        // moves an old linear-probing entry into table_, merging its values if
+        // the key was inserted again after the resize started
+        void placeProbeEntry(Entry* entry) {
+            size_t home = entry->hash % capacity_;
+            size_t index = linearProbe(table_, home, entry->key, entry->hash);
+            if (!table_[index]) {
+                size_t distance = (index + capacity_ - home) % capacity_;
+                table_[index] = entry;
+                stats_.usedBuckets++;
+                recordChainLength(distance + 1);
+                recordProbeDistance(distance);
+                return;
+            }
+            appendValues(table_[index]->values, entry->values);
+            destroyEntry(entry);
+            size_--;
+        }
+
+        static void initRobin(RobinHoodSlots& slots, size_t requestedSlots) {
+            size_t capacity = 1;
+            while (capacity < requestedSlots) {
+                capacity <<= 1;
+            }
+            slots.assign(capacity, RobinHoodSlot{});
+        }
+
+        static size_t robinHomeOf(size_t h, size_t capacity) {
+            return mixHash(h) & (capacity - 1);
+        }
+
+        // inserts incoming into robin_, merging into the slot of an equal key;
+        // returns false when the values were merged into an existing key
+        bool robinPlace(RobinHoodSlot incoming) {
+            size_t mask = robin_.size() - 1;
+            size_t pos = robinHomeOf(incoming.hash, robin_.size());
+            incoming.distance = 1;
+            bool original = true; // still carrying the caller's key, not a displaced one
+            while (true) {
+                RobinHoodSlot& slot = robin_[pos];
+                if (slot.distance == 0) {
+                    if (original) recordChainLength(incoming.distance);
+                    recordProbeDistance(incoming.distance - 1);
+                    slot = std::move(incoming);
+                    stats_.usedBuckets++;
+                    return true;
+                }
+                if (original && slot.distance == incoming.distance && slot.hash == incoming.hash &&
+                    slot.key == incoming.key) {
+                    appendValues(slot.values, incoming.values);
+                    return false;
+                }
+                if (slot.distance < incoming.distance) {
+                    // the resident is closer to home than we are: take its slot
+                    // and carry it forward instead
+                    if (original) recordChainLength(incoming.distance);
+                    recordProbeDistance(incoming.distance - 1);
+                    forgetProbeDistance(slot.distance - 1);
+                    std::swap(slot, incoming);
+                    original = false;
+                }
+                pos = (pos + 1) & mask;
+                incoming.distance++;
+            }
+        }
+
+        // index of key's slot, or slots.size() when absent; h is hasher_(key)
+        static size_t robinFind(const RobinHoodSlots& slots, const Key& key, size_t h) {
+            size_t mask = slots.size() - 1;
+            size_t pos = robinHomeOf(h, slots.size());
+            for (uint32_t distance = 1; ; ++distance) {
+                const RobinHoodSlot& slot = slots[pos];
+                // an entry this close to home would have been displaced by key
+                if (slot.distance < distance) {
+                    return slots.size();
+                }
+                if (slot.distance == distance && slot.hash == h && slot.key == key) {
+                    return pos;
+                }
+                pos = (pos + 1) & mask;
+            }
+        }
+
+        // backward-shift deletion: pull the following run one slot closer to
+        // home instead of leaving a tombstone
+        size_t robinErase(RobinHoodSlots& slots, const Key& key, bool counted) {
+            size_t pos = robinFind(slots, key, hasher_(key));
+            if (pos == slots.size()) {
+                return 0;
+            }
+            size_t mask = slots.size() - 1;
+            size_t removed = slots[pos].values.size();
+            if (counted) {
+                forgetProbeDistance(slots[pos].distance - 1);
+                stats_.usedBuckets--;
+            }
+            size_t next = (pos + 1) & mask;
+            while (slots[next].distance > 1) {
+                slots[pos] = std::move(slots[next]);
+                slots[pos].distance--;
+                if (counted) probeDistanceTotal_--;
+                pos = next;
+                next = (next + 1) & mask;
+            }
+            slots[pos] = RobinHoodSlot{};
+            size_--;
+            return removed;
+        }
+
+        // Knuth's algorithm R: after emptying a slot, move back any later entry
+        // of the cluster whose home does not lie between the hole and itself
+        size_t linearErase(Buckets& table, const Key& key, bool counted) {
+            size_t capacity = table.size();
+            size_t h = hasher_(key);
+            size_t pos = linearProbe(table, h % capacity, key, h);
+            if (pos == capacity || !table[pos]) {
+                return 0;
+            }
+            size_t removed = table[pos]->values.size();
+            if (counted) {
+                forgetProbeDistance((pos + capacity - h % capacity) % capacity);
+                stats_.usedBuckets--;
+            }
+            destroyEntry(table[pos]);
+            table[pos] = nullptr;
+            size_t hole = pos;
+            size_t next = pos;
+            while (true) {
+                next = (next + 1) % capacity;
+                if (!table[next]) break;
+                size_t home = table[next]->hash % capacity;
+                bool movable = hole <= next ? (home <= hole || home > next) : (home <= hole && home > next);
+                if (movable) {
+                    if (counted) probeDistanceTotal_ -= (next + capacity - hole) % capacity;
+                    table[hole] = table[next];
+                    table[next] = nullptr;
+                    hole = next;
+                }
+            }
+            size_--;
+            return removed;
+        }
+
+        size_t chainErase(Buckets& table, const Key& key, bool counted) {
+            size_t removed = 0;
+            size_t position = 0;
+            size_t removedNodes = 0;
+            size_t h = hasher_(key);
+            size_t index = h % table.size();
+            Entry** link = &table[index];
+            while (*link) {
+                if (entryMatches(*link, key, h)) {
+                    Entry* erased = *link;
+                    removed += erased->values.size();
+                    if (counted) forgetProbeDistance(position);
+                    *link = erased->next;
+                    destroyEntry(erased);
+                    removedNodes++;
+                    size_--;
+                } else {
+                    if (counted) probeDistanceTotal_ -= removedNodes;
+                    link = &(*link)->next;
+                }
+                position++;
+            }
+            if (counted && removedNodes > 0 && !table[index]) {
+                stats_.usedBuckets--;
+            }
+            return removed;
+        }
+
+        size_t swissErase(SwissSlots& slots, size_t h, const Key& key, bool counted) {
+            size_t removed = 0;
+            int8_t tag = h2(h);
+            size_t group = h1(h, slots.groupMask);
+            for (size_t probe = 0; probe <= slots.groupMask; ++probe) {
+                int8_t* ctrl = &slots.ctrl[group * GROUP_WIDTH];
+                uint32_t candidates = matchGroup(ctrl, tag);
+                while (candidates) {
+                    size_t slot = group * GROUP_WIDTH + lowestBit(candidates);
+                    if (slots.hashes[slot] == h && slots.keys[slot] == key) {
+                        slots.ctrl[slot] = CTRL_DELETED;
+                        slots.keys[slot] = Key{};
+                        if (counted) {
+                            forgetProbeDistance(probe);
+                            stats_.usedBuckets--;
+                            swissTombstones_++;
+                        }
+                        removed++;
+                        size_--;
+                    }
+                    candidates &= candidates - 1;
+                }
+                if (matchGroup(ctrl, CTRL_EMPTY)) {
+                    break;
+                }
+                group = (group + probe + 1) & slots.groupMask;
+            }
+            return removed;
+        }
+
+        static void initCuckoo(CuckooBuckets& buckets, size_t requestedSlots) {
+            size_t bucketCount = 2;
+            while (bucketCount * CUCKOO_WAYS < requestedSlots) {
+                bucketCount <<= 1;
+            }
+            buckets.bucketMask = bucketCount - 1;
+            buckets.tags.assign(bucketCount * CUCKOO_WAYS, 0);
+            buckets.slots.assign(bucketCount * CUCKOO_WAYS, CuckooEntry{});
+            buckets.stash.clear();
+        }
+
+        // for a lookup: h is hasher_(key); the secondary bucket still needs altHasher_
+        CuckooHashes cuckooHashes(const Key& key, size_t primaryHash, size_t bucketMask) const {
+            return cuckooHashesOf(primaryHash, altHasher_(key), bucketMask);
+        }
+
+        // for a stored entry: both hashes are kept with it
+        static CuckooHashes cuckooHashesOf(const CuckooEntry& entry, size_t bucketMask) {
+            return cuckooHashesOf(entry.hash, entry.altHash, bucketMask);
+        }
+
+        static CuckooHashes cuckooHashesOf(size_t primaryHash, size_t altHash, size_t bucketMask) {
+            size_t h = mixHash(primaryHash);
+            // salted so the two buckets differ even when both hashers agree
+            size_t alt = mixHash(altHash ^ 0x9E3779B97F4A7C15ULL);
+            CuckooHashes hashes;
+            hashes.hash = primaryHash;
+            hashes.primary = h & bucketMask;
+            hashes.secondary = alt & bucketMask;
+            if (hashes.secondary == hashes.primary) {
+                hashes.secondary = (hashes.primary + 1) & bucketMask;
+            }
+            hashes.tag = static_cast<uint8_t>(h >> 56);
+            if (hashes.tag == 0) hashes.tag = 1;
+            return hashes;
+        }
+
+        // slot index of key, slots.size() + i for stash entry i, or CUCKOO_NOT_FOUND
+        static size_t cuckooLocate(const CuckooBuckets& buckets, const Key& key, const CuckooHashes& hashes) {
+            for (size_t bucket : {hashes.primary, hashes.secondary}) {
+                const uint8_t* tags = &buckets.tags[bucket * CUCKOO_WAYS];
+                for (size_t way = 0; way < CUCKOO_WAYS; ++way) {
+                    size_t slot = bucket * CUCKOO_WAYS + way;
+                    const CuckooEntry& entry = buckets.slots[slot];
+                    if (tags[way] == hashes.tag && entry.hash == hashes.hash && entry.key == key) {
+                        return slot;
+                    }
+                }
+            }
+            for (size_t i = 0; i < buckets.stash.size(); ++i) {
+                if (buckets.stash[i].hash == hashes.hash && buckets.stash[i].key == key) {
+                    return buckets.slots.size() + i;
+                }
+            }
+            return CUCKOO_NOT_FOUND;
+        }
+
+        CuckooEntry& cuckooEntryAt(CuckooBuckets& buckets, size_t pos) {
+            return pos < buckets.slots.size() ? buckets.slots[pos] : buckets.stash[pos - buckets.slots.size()];
+        }
+
+        bool cuckooTryBucket(size_t bucket, uint8_t tag, CuckooEntry& entry, size_t distance) {
+            uint8_t* tags = &cuckoo_.tags[bucket * CUCKOO_WAYS];
+            for (size_t way = 0; way < CUCKOO_WAYS; ++way) {
+                if (tags[way] == 0) {
+                    tags[way] = tag;
+                    cuckoo_.slots[bucket * CUCKOO_WAYS + way] = std::move(entry);
+                    recordProbeDistance(distance);
+                    stats_.usedBuckets++;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // inserts incoming into cuckoo_, merging into an equal key's entry;
+        // returns false when the values were merged into an existing key
+        bool cuckooPlace(CuckooEntry incoming) {
+            CuckooHashes hashes = cuckooHashesOf(incoming, cuckoo_.bucketMask);
+            size_t pos = cuckooLocate(cuckoo_, incoming.key, hashes);
+            if (pos != CUCKOO_NOT_FOUND) {
+                appendValues(cuckooEntryAt(cuckoo_, pos).values, incoming.values);
+                return false;
+            }
+            if (cuckooTryBucket(hashes.primary, hashes.tag, incoming, 0)) {
+                recordChainLength(1);
+                return true;
+            }
+            if (cuckooTryBucket(hashes.secondary, hashes.tag, incoming, 1)) {
+                recordChainLength(2);
+                return true;
+            }
+            recordChainLength(3);
+
+            // kick-out walk: evict a resident of the current bucket and move it
+            // to its other bucket until some bucket has room
+            size_t bucket = hashes.primary;
+            uint8_t tag = hashes.tag;
+            size_t distance = 0;
+            for (size_t kick = 0; kick < CUCKOO_MAX_KICKS; ++kick) {
+                size_t slot = bucket * CUCKOO_WAYS + (cuckooKicks_++ % CUCKOO_WAYS);
+                std::swap(incoming, cuckoo_.slots[slot]);
+                std::swap(tag, cuckoo_.tags[slot]);
+                recordProbeDistance(distance);
+
+                CuckooHashes victim = cuckooHashesOf(incoming, cuckoo_.bucketMask);
+                forgetProbeDistance(bucket == victim.primary ? 0 : 1);
+                bucket = bucket == victim.primary ? victim.secondary : victim.primary;
+                distance = bucket == victim.primary ? 0 : 1;
+                if (cuckooTryBucket(bucket, tag, incoming, distance)) {
+                    return true;
+                }
+            }
+            // the stash normally holds a handful of entries; reaching the
+            // limit forces a resize on the next insert
+            cuckoo_.stash.push_back(std::move(incoming));
+            recordProbeDistance(2);
+            stats_.usedBuckets++;
+            return true;
+        }
+
+        size_t cuckooErase(CuckooBuckets& buckets, const Key& key, bool counted) {
+            CuckooHashes hashes = cuckooHashes(key, hasher_(key), buckets.bucketMask);
+            size_t pos = cuckooLocate(buckets, key, hashes);
+            if (pos == CUCKOO_NOT_FOUND) {
+                return 0;
+            }
+            CuckooEntry& entry = cuckooEntryAt(buckets, pos);
+            size_t removed = entry.values.size();
+            if (counted) {
+                size_t distance = pos >= buckets.slots.size() ? 2 :
+                    (pos / CUCKOO_WAYS == hashes.primary ? 0 : 1);
+                forgetProbeDistance(distance);
+                stats_.usedBuckets--;
+            }
+            if (pos < buckets.slots.size()) {
+                buckets.tags[pos] = 0;
+                buckets.slots[pos] = CuckooEntry{};
+            } else {
+                buckets.stash.erase(buckets.stash.begin() + (pos - buckets.slots.size()));
+            }
+            size_--;
+            return removed;
+        }
+
+        bool needsGrowth() const {
+            if (strategy() == CollisionStrategy::CUCKOO) {
+                return cuckoo_.stash.size() >= cuckooStashLimit_ ||
+                       static_cast<double>(size_ + 1) > capacity_ * CUCKOO_LOAD_FACTOR_THRESHOLD;
+            }
+            if (strategy() == CollisionStrategy::SWISS) {
+                return static_cast<double>(size_ + swissTombstones_ + 1) > capacity_ * SWISS_LOAD_FACTOR_THRESHOLD;
+            }
+            return static_cast<double>(size_ + 1) > capacity_ * LOAD_FACTOR_THRESHOLD;
+        }
+
+        void resize() {
+            if (migrating()) {
+                finishMigration();
+            }
+            stats_.resizes++;
+            if (strategy() == CollisionStrategy::SWISS) {
+                oldSwiss_ = std::move(swiss_);
+                oldCapacity_ = oldSwiss_.ctrl.size();
+                // mostly tombstones: rebuild at the same size instead of doubling
+                bool crowded = (size_ + 1) * 2 > oldCapacity_ * SWISS_LOAD_FACTOR_THRESHOLD;
+                initSwiss(swiss_, crowded ? oldCapacity_ * 2 : oldCapacity_);
+                capacity_ = swiss_.ctrl.size();
+                swissTombstones_ = 0;
+            } else if (strategy() == CollisionStrategy::CUCKOO) {
+                oldCuckoo_ = std::move(cuckoo_);
+                oldCapacity_ = oldCuckoo_.slots.size();
+                initCuckoo(cuckoo_, oldCapacity_ * 2);
+                capacity_ = cuckoo_.slots.size();
+            } else if (strategy() == CollisionStrategy::ROBIN_HOOD) {
+                oldRobin_ = std::move(robin_);
+                oldCapacity_ = oldRobin_.size();
+                initRobin(robin_, oldCapacity_ * 2);
+                capacity_ = robin_.size();
+                migrateStart_ = 0;
+                while (migrateStart_ < oldCapacity_ && oldRobin_[migrateStart_].distance != 0) {
+                    migrateStart_++;
+                }
+            } else {
+                oldTable_ = std::move(table_);
+                oldCapacity_ = oldTable_.size();
+                capacity_ = std::max<size_t>(oldCapacity_ * 2, 1);
+                table_ = Buckets(capacity_);
+                if (strategy() == CollisionStrategy::LINEAR_PROBING) {
+                    migrateStart_ = 0;
+                    while (migrateStart_ < oldCapacity_ && oldTable_[migrateStart_]) {
+                        migrateStart_++;
+                    }
+                }
+            }
+            migrateCursor_ = 0;
+            resetStats();
+            if (!GrowthPolicy::INCREMENTAL) {
+                finishMigration();
+            }
+        }
+
+        // migrates at least `buckets` old buckets (or groups); returns once the
+        // old table is empty
+        void migrateStep(size_t buckets) {
+            if (strategy() == CollisionStrategy::SWISS) {
+                size_t groups = oldSwiss_.groupMask + 1;
+                for (size_t n = 0; n < buckets && migrateCursor_ < groups; ++n, ++migrateCursor_) {
+                    for (size_t i = 0; i < GROUP_WIDTH; ++i) {
+                        size_t slot = migrateCursor_ * GROUP_WIDTH + i;
+                        if (oldSwiss_.ctrl[slot] < 0) continue;
+                        swissPlace(oldSwiss_.hashes[slot], oldSwiss_.keys[slot], oldSwiss_.values[slot]);
+                        oldSwiss_.ctrl[slot] = CTRL_DELETED;
+                    }
+                }
+                if (migrateCursor_ == groups) {
+                    oldSwiss_ = SwissSlots{};
+                    oldCapacity_ = 0;
+                }
+            } else if (strategy() == CollisionStrategy::CUCKOO) {
+                // lookups check both buckets regardless of empties, so buckets
+                // can be moved in any order; the stash goes last
+                size_t bucketCount = oldCuckoo_.bucketMask + 1;
+                for (size_t n = 0; n < buckets && migrateCursor_ < bucketCount; ++n, ++migrateCursor_) {
+                    for (size_t way = 0; way < CUCKOO_WAYS; ++way) {
+                        size_t slot = migrateCursor_ * CUCKOO_WAYS + way;
+                        if (oldCuckoo_.tags[slot] == 0) continue;
+                        if (!cuckooPlace(std::move(oldCuckoo_.slots[slot]))) size_--;
+                        oldCuckoo_.tags[slot] = 0;
+                        oldCuckoo_.slots[slot] = CuckooEntry{};
+                    }
+                }
+                if (migrateCursor_ == bucketCount) {
+                    for (auto& entry : oldCuckoo_.stash) {
+                        if (!cuckooPlace(std::move(entry))) size_--;
+                    }
+                    oldCuckoo_ = CuckooBuckets{};
+                    oldCapacity_ = 0;
+                    // still over the limit at twice the size: these keys share
+                    // both buckets at any size (e.g. equal hash pairs), so the
+                    // stash grows instead of the table until a load-factor
+                    // resize brings it back under the limit
+                    cuckooStashLimit_ = cuckoo_.stash.size() < CUCKOO_STASH_LIMIT ?
+                        CUCKOO_STASH_LIMIT : std::numeric_limits<size_t>::max();
+                }
+            } else if (strategy() == CollisionStrategy::ROBIN_HOOD) {
+                // same cluster-aligned walk as linear probing below
+                size_t n = 0;
+                while (migrateCursor_ < oldCapacity_) {
+                    size_t pos = (migrateStart_ + 1 + migrateCursor_) & (oldCapacity_ - 1);
+                    migrateCursor_++;
+                    n++;
+                    if (oldRobin_[pos].distance != 0) {
+                        if (!robinPlace(std::move(oldRobin_[pos]))) size_--;
+                        oldRobin_[pos] = RobinHoodSlot{};
+                    } else if (n >= buckets) {
+                        break;
+                    }
+                }
+                if (migrateCursor_ == oldCapacity_) {
+                    oldRobin_ = RobinHoodSlots{};
+                    oldCapacity_ = 0;
+                }
+            } else if (strategy() == CollisionStrategy::CHAINING) {
+                for (size_t n = 0; n < buckets && migrateCursor_ < oldCapacity_; ++n, ++migrateCursor_) {
+                    Entry* entry = oldTable_[migrateCursor_];
+                    oldTable_[migrateCursor_] = nullptr;
+                    while (entry) {
+                        Entry* next = entry->next;
+                        entry->next = nullptr;
+                        placeChainEntry(entry);
+                        entry = next;
+                    }
+                }
+                if (migrateCursor_ == oldCapacity_) {
+                    oldTable_ = Buckets{};
+                    oldCapacity_ = 0;
+                }
+            } else {
+                // walk from just after an empty slot and only stop right after
+                // another one, so old-table probes never see half a cluster
+                size_t n = 0;
+                while (migrateCursor_ < oldCapacity_) {
+                    size_t pos = (migrateStart_ + 1 + migrateCursor_) % oldCapacity_;
+                    migrateCursor_++;
+                    n++;
+                    if (oldTable_[pos]) {
+                        placeProbeEntry(oldTable_[pos]);
+                        oldTable_[pos] = nullptr;
+                    } else if (n >= buckets) {
+                        break;
+                    }
+                }
+                if (migrateCursor_ == oldCapacity_) {
+                    oldTable_ = Buckets{};
+                    oldCapacity_ = 0;
+                }
+            }
+        }
+
+        void finishMigration() {
+            while (oldCapacity_ > 0) {
+                migrateStep(oldCapacity_);
+            }
+        }
+
+        template<typename Callback>
+        size_t findIn(const Buckets& table, const Key& key, size_t h, Callback& callback) const {
+            size_t matches = 0;
+            size_t index = h % table.size();
+            if (strategy() == CollisionStrategy::CHAINING) {
+                for (const Entry* current = table[index]; current; current = current->next) {
+                    if (entryMatches(current, key, h)) {
+                        for (const auto& value : current->values) callback(value);
+                        matches += current->values.size();
+                    }
+                }
+            } else {
+                index = linearProbe(table, index, key, h);
+                if (index < table.size() && table[index]) {
+                    for (const auto& value : table[index]->values) callback(value);
+                    matches += table[index]->values.size();
+                }
             }
-            return capacity_; // Table is full
+            return matches;
         }
 
     public:
         CustomHashTable(size_t initialCapacity = 16, CollisionStrategy strategy = CollisionStrategy::CHAINING)
-            : size_(0), capacity_(initialCapacity), strategy_(strategy), hasher_() {
-            table_.resize(capacity_);
+            : size_(0), capacity_(std::max<size_t>(initialCapacity, 1)), strategy_(StrategyPolicy::resolve(strategy)), hasher_(), altHasher_() {
+            initStorage();
         }
 
         CustomHashTable(size_t capacity, CollisionStrategy strategy, Hash hasher)
-            : size_(0), capacity_(capacity), strategy_(strategy), hasher_(std::move(hasher)) {
-            table_.resize(capacity_);
+            : size_(0), capacity_(std::max<size_t>(capacity, 1)), strategy_(StrategyPolicy::resolve(strategy)), hasher_(hasher), altHasher_(std::move(hasher)) {
+            initStorage();
+        }
+
+        // altHasher is CUCKOO's second hash function (e.g. the same hasher with
+        // another seed); the other strategies ignore it
+        CustomHashTable(size_t capacity, CollisionStrategy strategy, Hash hasher, Hash altHasher)
+            : size_(0), capacity_(std::max<size_t>(capacity, 1)), strategy_(StrategyPolicy::resolve(strategy)),
+              hasher_(std::move(hasher)), altHasher_(std::move(altHasher)) {
+            initStorage();
+        }
+
+        ~CustomHashTable() {
+            destroyEntries(table_);
+            destroyEntries(oldTable_);
+        }
+
+        // entries are raw pointers into arena_, so tables are not copied
+        CustomHashTable(const CustomHashTable&) = delete;
+        CustomHashTable& operator=(const CustomHashTable&) = delete;
+
+        // initial capacity that holds expectedEntries without growing
+        static size_t capacityFor(size_t expectedEntries) {
+            return static_cast<size_t>(expectedEntries / LOAD_FACTOR_THRESHOLD) + 1;
         }
 
         void insert(const Key& key, const Value& value) {
-            size_t index = hash(key);
+            insertHashed(key, hasher_(key), value);
+        }
 
-            if (strategy_ == CollisionStrategy::CHAINING) {
-                if (!table_[index]) {
-                    table_[index] = std::make_unique<Entry>(key, value);
-                } else {
-                    auto current = table_[index].get();
-                    while (current->next) {
-                        current = current->next.get();
-                    }
-                    current->next = std::make_unique<Entry>(key, value);
-                }
+        // insert with h = hashOf(key) already computed
+        void insertHashed(const Key& key, size_t h, const Value& value) {
+            if (needsGrowth()) {
+                resize();
+            } else if (migrating()) {
+                migrateStep(MIGRATION_BUCKETS_PER_OP);
+            }
+
+            if (PayloadPolicy::UNIQUE && migrating() && assignInOld(h, key, value)) {
+                return;
+            }
+
+            if (strategy() == CollisionStrategy::SWISS) {
+                if (PayloadPolicy::UNIQUE && swissAssign(swiss_, mixHash(h), key, value)) return;
+                swissPlace(mixHash(h), key, value);
+                size_++;
+                stats_.totalEntries = size_;
+                return;
+            }
+
+            if (strategy() == CollisionStrategy::CUCKOO) {
+                CuckooEntry incoming;
+                incoming.key = key;
+                incoming.hash = h;
+                incoming.altHash = altHasher_(key);
+                incoming.values = singleValue(value);
+                if (cuckooPlace(std::move(incoming))) size_++;
+                stats_.totalEntries = size_;
+                return;
+            }
+
+            if (strategy() == CollisionStrategy::ROBIN_HOOD) {
+                RobinHoodSlot incoming;
+                incoming.key = key;
+                incoming.hash = h;
+                incoming.values = singleValue(value);
+                if (robinPlace(std::move(incoming))) size_++;
+                stats_.totalEntries = size_;
+                return;
+            }
+
+            if (strategy() == CollisionStrategy::CHAINING) {
+                if (PayloadPolicy::UNIQUE && chainAssign(table_, h, key, value)) return;
+                placeChainEntry(newEntry(key, h, value));
                 size_++;
             } else {
-                index = linearProbe(index, key);
+                size_t home = h % capacity_;
+                size_t index = linearProbe(table_, home, key, h);
                 if (index < capacity_) {
                     if (!table_[index]) {
-                        table_[index] = std::make_unique<Entry>(key, value);
+                        size_t distance = (index + capacity_ - home) % capacity_;
+                        table_[index] = newEntry(key, h, value);
+                        stats_.usedBuckets++;
+                        recordChainLength(distance + 1);
+                        recordProbeDistance(distance);
                         size_++;
                     } else {
-                        table_[index]->values.push_back(value);
+                        pushValue(table_[index]->values, value);
                     }
                 }
             }
-            updateStats();
+            stats_.totalEntries = size_;
         }
 
-        std::vector<Value> find(const Key& key) const {
-            std::vector<Value> results;
-            size_t index = hash(key);
+        // calls callback(const Value&) for every value stored under key, without
+        // allocating; returns the number of matches
+        template<typename Callback>
+        size_t forEachMatch(const Key& key, Callback&& callback) const {
+            return forEachMatchHashed(key, hashOf(key), callback);
+        }
 
-            if (strategy_ == CollisionStrategy::CHAINING) {
-                auto current = table_[index].get();
-                while (current) {
-                    if (current->key == key) {
-                        results.insert(results.end(), current->values.begin(), current->values.end());
-                    }
-                    current = current->next.get();
-                }
+        // Batched probing: hash a group of keys with hashOf() and call
+        // prefetchBucket() for each, then prefetchEntry() for each, then
+        // resolve them with forEachMatchHashed(). By the time a key is
+        // resolved its memory is (ideally) already in cache. The prefetches
+        // are hints only and look at the current table, not one being
+        // migrated away from.
+        size_t hashOf(const Key& key) const {
+            return hasher_(key);
+        }
+
+        // out[i] = hashOf(*keys[i]) for a whole group in one call
+        void hashOfBatch(const Key* const* keys, size_t count, size_t* out) const {
+            hashKeys(hasher_, keys, count, out);
+        }
+
+        // first line a lookup touches: bucket pointer, SWISS control group,
+        // Robin Hood home slot, or CUCKOO primary tag word
+        void prefetchBucket(size_t h) const {
+            if (strategy() == CollisionStrategy::SWISS) {
+                __builtin_prefetch(&swiss_.ctrl[h1(mixHash(h), swiss_.groupMask) * GROUP_WIDTH]);
+            } else if (strategy() == CollisionStrategy::ROBIN_HOOD) {
+                __builtin_prefetch(&robin_[robinHomeOf(h, robin_.size())]);
+            } else if (strategy() == CollisionStrategy::CUCKOO) {
+                __builtin_prefetch(&cuckoo_.tags[(mixHash(h) & cuckoo_.bucketMask) * CUCKOO_WAYS]);
             } else {
-                index = linearProbe(index, key);
-                if (index < capacity_ && table_[index] && table_[index]->key == key) {
-                    results = table_[index]->values;
+                __builtin_prefetch(&table_[h % capacity_]);
+            }
+        }
+
+        // what the bucket leads to: the chain/probe node (reads the bucket
+        // pointer, so call prefetchBucket() a while before), SWISS key slots
+        // or CUCKOO primary entries. Robin Hood slots hold their keys inline.
+        void prefetchEntry(size_t h) const {
+            if (strategy() == CollisionStrategy::SWISS) {
+                __builtin_prefetch(&swiss_.keys[h1(mixHash(h), swiss_.groupMask) * GROUP_WIDTH]);
+            } else if (strategy() == CollisionStrategy::CUCKOO) {
+                __builtin_prefetch(&cuckoo_.slots[(mixHash(h) & cuckoo_.bucketMask) * CUCKOO_WAYS]);
+            } else if (strategy() != CollisionStrategy::ROBIN_HOOD) {
+                const Entry* entry = table_[h % capacity_];
+                if (entry) __builtin_prefetch(entry);
+            }
+        }
+
+        // forEachMatch with h = hashOf(key) already computed
+        template<typename Callback>
+        size_t forEachMatchHashed(const Key& key, size_t h, Callback&& callback) const {
+            size_t matches = 0;
+            if (strategy() == CollisionStrategy::SWISS) {
+                size_t mixed = mixHash(h);
+                matches += swissFind(swiss_, mixed, key, callback);
+                if (migrating()) matches += swissFind(oldSwiss_, mixed, key, callback);
+                return matches;
+            }
+
+            if (strategy() == CollisionStrategy::CUCKOO) {
+                for (const CuckooBuckets* buckets : {&cuckoo_, &oldCuckoo_}) {
+                    if (buckets->empty()) continue;
+                    size_t pos = cuckooLocate(*buckets, key, cuckooHashes(key, h, buckets->bucketMask));
+                    if (pos == CUCKOO_NOT_FOUND) continue;
+                    const auto& entry = pos < buckets->slots.size() ?
+                        buckets->slots[pos] : buckets->stash[pos - buckets->slots.size()];
+                    for (const auto& value : entry.values) callback(value);
+                    matches += entry.values.size();
                 }
+                return matches;
             }
+
+            if (strategy() == CollisionStrategy::ROBIN_HOOD) {
+                for (const RobinHoodSlots* slots : {&robin_, &oldRobin_}) {
+                    if (slots->empty()) continue;
+                    size_t pos = robinFind(*slots, key, h);
+                    if (pos == slots->size()) continue;
+                    for (const auto& value : (*slots)[pos].values) callback(value);
+                    matches += (*slots)[pos].values.size();
+                }
+                return matches;
+            }
+
+            matches += findIn(table_, key, h, callback);
+            if (migrating()) matches += findIn(oldTable_, key, h, callback);
+            return matches;
+        }
+
+        std::vector<Value> find(const Key& key) const {
+            std::vector<Value> results;
+            forEachMatch(key, [&results](const Value& value) { results.push_back(value); });
             return results;
         }
 
         bool contains(const Key& key) const {
-            return !find(key).empty();
+            return forEachMatch(key, [](const Value&) {}) > 0;
         }
 
+        // removes every value stored under key; returns how many were removed
+        size_t erase(const Key& key) {
+            size_t removed = 0;
+            if (strategy() == CollisionStrategy::SWISS) {
+                size_t h = mixHash(hasher_(key));
+                removed += swissErase(swiss_, h, key, true);
+                if (migrating()) removed += swissErase(oldSwiss_, h, key, false);
+            } else if (strategy() == CollisionStrategy::CUCKOO) {
+                removed += cuckooErase(cuckoo_, key, true);
+                if (migrating()) removed += cuckooErase(oldCuckoo_, key, false);
+            } else if (strategy() == CollisionStrategy::ROBIN_HOOD) {
+                removed += robinErase(robin_, key, true);
+                if (migrating()) removed += robinErase(oldRobin_, key, false);
+            } else if (strategy() == CollisionStrategy::CHAINING) {
+                removed += chainErase(table_, key, true);
+                if (migrating()) removed += chainErase(oldTable_, key, false);
+            } else {
+                removed += linearErase(table_, key, true);
+                if (migrating()) removed += linearErase(oldTable_, key, false);
+            }
+            stats_.totalEntries = size_;
+            return removed;
+        }
+
+        // no per-entry frees: the arena drops its blocks in one go (only key
+        // destructors run, and only for keys that have one)
         void clear() {
+            destroyEntries(table_);
+            destroyEntries(oldTable_);
+            oldTable_ = Buckets{};
+            oldSwiss_ = SwissSlots{};
+            oldRobin_ = RobinHoodSlots{};
+            oldCuckoo_ = CuckooBuckets{};
+            oldCapacity_ = 0;
+            swissTombstones_ = 0;
             table_.clear();
-            table_.resize(capacity_);
+            // slots holding value lists must go before the arena memory does
+            robin_.clear();
+            cuckoo_ = CuckooBuckets{};
+            cuckooStashLimit_ = CUCKOO_STASH_LIMIT;
+            arena_.reset();
+            initStorage();
             size_ = 0;
-            updateStats();
         }
 
         size_t size() const { return size_; }
         bool empty() const { return size_ == 0; }
 
-        void updateStats() {
-            stats_ = HashTableStats{};
+        const HashTableStats& getStats() const {
             stats_.totalBuckets = capacity_;
-            
-            for (const auto& bucket : table_) {
-                if (bucket) {
-                    stats_.usedBuckets++;
-                    size_t chainLength = 1;
-                    auto current = bucket->next.get();
-                    while (current) {
+            stats_.loadFactor = capacity_ > 0 ?
+                static_cast<double>(stats_.usedBuckets) / capacity_ : 0.0;
+            stats_.avgChainLength = stats_.usedBuckets > 0 ?
+                static_cast<double>(size_) / stats_.usedBuckets : 0.0;
+            stats_.memoryUsage = sizeof(*this) + arena_.bytesReserved() +
+                (table_.capacity() + oldTable_.capacity()) * sizeof(Entry*) +
+                swiss_.bytes() + oldSwiss_.bytes() +
+                (robin_.capacity() + oldRobin_.capacity()) * sizeof(RobinHoodSlot) +
+                cuckoo_.bytes() + oldCuckoo_.bytes();
+            stats_.avgProbeDistance = probeSamples_ > 0 ?
+                static_cast<double>(probeDistanceTotal_) / probeSamples_ : 0.0;
+            return stats_;
+        }
+
+        DetailedHashTableStats computeDetailedStats() const {
+            DetailedHashTableStats detailed;
+            detailed.summary = getStats();
+
+            if (strategy() == CollisionStrategy::SWISS) {
+                for (size_t group = 0; group <= swiss_.groupMask; ++group) {
+                    size_t occupied = 0;
+                    for (size_t i = 0; i < GROUP_WIDTH; ++i) {
+                        size_t slot = group * GROUP_WIDTH + i;
+                        if (swiss_.ctrl[slot] < 0) continue;
+                        occupied++;
+                        size_t probeGroup = h1(swiss_.hashes[slot], swiss_.groupMask);
+                        size_t distance = 0;
+                        while (probeGroup != group) {
+                            distance++;
+                            probeGroup = (probeGroup + distance) & swiss_.groupMask;
+                        }
+                        addHistogramSample(detailed.probeDistanceHistogram, distance);
+                    }
+                    addHistogramSample(detailed.chainLengthHistogram, occupied);
+                }
+            } else if (strategy() == CollisionStrategy::CUCKOO) {
+                // chain length here is bucket occupancy (0..CUCKOO_WAYS)
+                for (size_t bucket = 0; bucket <= cuckoo_.bucketMask; ++bucket) {
+                    size_t occupied = 0;
+                    for (size_t way = 0; way < CUCKOO_WAYS; ++way) {
+                        size_t slot = bucket * CUCKOO_WAYS + way;
+                        if (cuckoo_.tags[slot] == 0) continue;
+                        occupied++;
+                        CuckooHashes hashes = cuckooHashesOf(cuckoo_.slots[slot], cuckoo_.bucketMask);
+                        addHistogramSample(detailed.probeDistanceHistogram, bucket == hashes.primary ? 0 : 1);
+                    }
+                    addHistogramSample(detailed.chainLengthHistogram, occupied);
+                }
+                for (size_t i = 0; i < cuckoo_.stash.size(); ++i) {
+                    addHistogramSample(detailed.probeDistanceHistogram, 2);
+                }
+            } else if (strategy() == CollisionStrategy::ROBIN_HOOD) {
+                size_t run = 0;
+                for (const auto& slot : robin_) {
+                    if (slot.distance != 0) {
+                        run++;
+                        addHistogramSample(detailed.probeDistanceHistogram, slot.distance - 1);
+                    } else {
+                        addHistogramSample(detailed.chainLengthHistogram, run);
+                        run = 0;
+                    }
+                }
+                if (run > 0) addHistogramSample(detailed.chainLengthHistogram, run);
+            } else if (strategy() == CollisionStrategy::CHAINING) {
+                for (const auto& bucket : table_) {
+                    size_t chainLength = 0;
+                    for (const Entry* current = bucket; current; current = current->next) {
+                        addHistogramSample(detailed.probeDistanceHistogram, chainLength);
                         chainLength++;
-                        current = current->next.get();
                     }
-                    if (chainLength > 1) {
-                        stats_.collisions += (chainLength - 1);
+                    addHistogramSample(detailed.chainLengthHistogram, chainLength);
+                }
+            } else {
+                size_t run = 0;
+                for (size_t i = 0; i < capacity_; ++i) {
+                    if (table_[i]) {
+                        run++;
+                        size_t home = table_[i]->hash % capacity_;
+                        addHistogramSample(detailed.probeDistanceHistogram, (i + capacity_ - home) % capacity_);
+                    } else {
+                        addHistogramSample(detailed.chainLengthHistogram, run);
+                        run = 0;
                     }
-                    stats_.maxChainLength = std::max(stats_.maxChainLength, chainLength);
                 }
+                if (run > 0) addHistogramSample(detailed.chainLengthHistogram, run);
             }
-            
-            stats_.totalEntries = size_;
-            stats_.loadFactor = static_cast<double>(stats_.usedBuckets) / capacity_;
-            stats_.avgChainLength = stats_.usedBuckets > 0 ? 
-                static_cast<double>(size_) / stats_.usedBuckets : 0.0;
-            stats_.memoryUsage = estimateMemoryUsage();
-        }
-
-        const HashTableStats& getStats() const {
-            return stats_;
+            return detailed;
         }
 
+        // live bytes only: unlike stats memoryUsage this leaves out arena space
+        // held by erased entries, outgrown value arrays and unused block tails
         size_t estimateMemoryUsage() const {
             size_t total = sizeof(*this);
-            total += capacity_ * sizeof(std::unique_ptr<Entry>);
-            
-            for (const auto& bucket : table_) {
-                if (bucket) {
-                    total += sizeof(Entry);
-                    total += bucket->values.capacity() * sizeof(Value);
-                    auto current = bucket->next.get();
-                    while (current) {
-                        total += sizeof(Entry);
-                        total += current->values.capacity() * sizeof(Value);
-                        current = current->next.get();
+            total += swiss_.bytes() + oldSwiss_.bytes();
+            for (const RobinHoodSlots* slots : {&robin_, &oldRobin_}) {
+                total += slots->capacity() * sizeof(RobinHoodSlot);
+                for (const auto& slot : *slots) total += spilledBytes(slot.values);
+            }
+            for (const CuckooBuckets* buckets : {&cuckoo_, &oldCuckoo_}) {
+                total += buckets->bytes();
+                for (const auto& entry : buckets->slots) total += spilledBytes(entry.values);
+                for (const auto& entry : buckets->stash) total += spilledBytes(entry.values);
+            }
+            total += (table_.capacity() + oldTable_.capacity()) * sizeof(Entry*);
+
+            for (const Buckets* buckets : {&table_, &oldTable_}) {
+                for (const Entry* bucket : *buckets) {
+                    for (const Entry* current = bucket; current; current = current->next) {
+                        total += sizeof(Entry) + spilledBytes(current->values);
                     }
                 }
             }
             return total;
         }
-};
\ No newline at end of file
+};
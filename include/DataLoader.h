@@ -5,13 +5,26 @@
 #include "Value.h"
 #include "Table.h"
 
+class BloomFilter;
+
 class DataLoader {
     private:
         std::vector<std::string> split(const std::string& str, char delimiter);
         DataType inferType(const std::string& value);
         Value parseValue(const std::string& str, DataType type);
+        std::unique_ptr<Table> loadCSV(const std::string& filename, const std::string& tablename,
+                                       const std::string* filterColumn, const BloomFilter* filter);
+        // dictionary-encodes the STRING columns with at most one distinct
+        // value per MIN_ROWS_PER_STRING rows
+        void encodeStringColumns(Table& table);
+
+        static constexpr size_t MIN_ROWS_PER_STRING = 2;
 
     public:
         std::unique_ptr<Table> loadFromCSV(const std::string& filename, const std::string& tablename);
+        // only keeps rows whose filterColumn value may be in filter (e.g. the
+        // build side of a later join); other rows are never materialized
+        std::unique_ptr<Table> loadFromCSV(const std::string& filename, const std::string& tablename,
+                                           const std::string& filterColumn, const BloomFilter& filter);
         std::unique_ptr<Table> generateTestTable(const std::string& name, size_t rows, int seed);
 };
\ No newline at end of file
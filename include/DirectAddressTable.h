@@ -0,0 +1,104 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "CustomHashTable.h"
+#include "Table.h"
+
+// Join index for INTEGER keys that cover a dense range: key k lives at
+// position k - minKey of a plain array, so a lookup is a subtraction and a
+// bounds check, with no hashing and no key compares. A presence bitmap
+// answers misses without touching the offset array; the row ids of each
+// key are laid out contiguously as in CsrHashTable.
+class DirectAddressTable {
+    private:
+        int64_t minKey_ = 0;
+        size_t span_ = 0;                 // maxKey - minKey + 1
+        TrackedVector<uint64_t, MemoryComponent::HASH_TABLE> presence_;  // one bit per key in the span
+        TrackedVector<uint32_t, MemoryComponent::HASH_TABLE> offsets_;   // span + 1 entries
+        TrackedVector<uint32_t, MemoryComponent::HASH_TABLE> rowIds_;
+        size_t distinctKeys_ = 0;
+
+        DirectAddressTable() = default;
+
+    public:
+        // largest span accepted, as a multiple of the build row count; wider
+        // ranges would spend more on empty slots than a hash table costs
+        static constexpr size_t MAX_SPAN_PER_ROW = 4;
+        // spans up to this are always accepted, however few rows there are
+        static constexpr size_t MIN_SPAN_LIMIT = 1024;
+
+        static constexpr size_t NO_SLOT = static_cast<size_t>(-1);
+
+        // scans the column and builds the index if every key is a non-NULL
+        // INTEGER and the span is dense enough; otherwise returns nullptr and
+        // says why in rejectReason
+        static std::unique_ptr<DirectAddressTable> tryBuild(const Table& table, size_t columnIdx,
+                                                            std::string& rejectReason);
+        // same over a plain key array, e.g. dictionary codes; instantiated
+        // for int64_t and uint32_t keys
+        template<typename Key>
+        static std::unique_ptr<DirectAddressTable> tryBuild(const Key* keys, size_t rows,
+                                                            std::string& rejectReason);
+
+        size_t span() const { return span_; }
+        int64_t minKey() const { return minKey_; }
+
+        // lookup interface matches CustomHashTable's, for Value and int64_t
+        // keys; the "hash" is the key's position in the span, or NO_SLOT
+        // when the key cannot be present
+        size_t hashOf(const Value& key) const {
+            const int64_t* k = std::get_if<int64_t>(&key.data);
+            return k ? slotOf(*k) : NO_SLOT;
+        }
+
+        size_t hashOf(int64_t key) const { return slotOf(key); }
+
+        size_t slotOf(int64_t key) const {
+            uint64_t slot = static_cast<uint64_t>(key) - static_cast<uint64_t>(minKey_);
+            return slot < span_ ? static_cast<size_t>(slot) : NO_SLOT;
+        }
+
+        void hashOfBatch(const Value* const* keys, size_t count, size_t* out) const {
+            for (size_t i = 0; i < count; ++i) out[i] = hashOf(*keys[i]);
+        }
+
+        void hashOfBatch(const int64_t* const* keys, size_t count, size_t* out) const {
+            for (size_t i = 0; i < count; ++i) out[i] = slotOf(*keys[i]);
+        }
+
+        void prefetchBucket(size_t slot) const {
+            if (slot != NO_SLOT) __builtin_prefetch(&presence_[slot >> 6]);
+        }
+
+        void prefetchEntry(size_t slot) const {
+            if (slot != NO_SLOT) __builtin_prefetch(&offsets_[slot]);
+        }
+
+        template<typename Key, typename Callback>
+        size_t forEachMatchHashed(const Key&, size_t slot, Callback&& callback) const {
+            if (slot == NO_SLOT || !(presence_[slot >> 6] & (1ULL << (slot & 63)))) {
+                return 0;
+            }
+            for (uint32_t i = offsets_[slot]; i < offsets_[slot + 1]; ++i) {
+                callback(static_cast<size_t>(rowIds_[i]));
+            }
+            return offsets_[slot + 1] - offsets_[slot];
+        }
+
+        template<typename Callback>
+        size_t forEachMatch(const Value& key, Callback&& callback) const {
+            return forEachMatchHashed(key, hashOf(key), callback);
+        }
+
+        bool contains(const Value& key) const {
+            return forEachMatch(key, [](size_t) {}) > 0;
+        }
+
+        size_t size() const { return rowIds_.size(); }
+
+        // a "bucket" is a key position in the span
+        HashTableStats getStats() const;
+        DetailedHashTableStats computeDetailedStats() const;
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "MurmurHash3.h"
+
+// Raw per-type hash kernels. They take plain keys rather than Value, so the
+// caller decides the type once and no std::visit runs per key. The batch
+// forms are straight loops over contiguous keys that the compiler can
+// unroll and vectorize.
+
+// multiply-xorshift mixer: two multiplies and two shifts, every output bit
+// depends on every input bit
+inline uint64_t hashInt64(int64_t key, uint64_t seed) {
+    uint64_t x = static_cast<uint64_t>(key) ^ seed;
+    x *= 0x9E3779B97F4A7C15ULL;
+    x ^= x >> 32;
+    x *= 0xD6E8FEB86659FD93ULL;
+    x ^= x >> 32;
+    return x;
+}
+
+// -0.0 == 0.0, so both must hash alike
+inline uint64_t hashDouble(double key, uint64_t seed) {
+    if (key == 0.0) key = 0.0;
+    int64_t bits;
+    std::memcpy(&bits, &key, sizeof(bits));
+    return hashInt64(bits, seed);
+}
+
+inline uint64_t hashString(const char* data, size_t length, uint64_t seed) {
+    uint64_t hash[2];
+    MurmurHash3_x64_128(data, static_cast<int>(length), static_cast<uint32_t>(seed), hash);
+    return hash[0];
+}
+
+inline void hashInt64Batch(const int64_t* keys, size_t count, uint64_t seed, uint64_t* out) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = hashInt64(keys[i], seed);
+    }
+}
+
+inline void hashDoubleBatch(const double* keys, size_t count, uint64_t seed, uint64_t* out) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = hashDouble(keys[i], seed);
+    }
+}
@@ -1,9 +1,12 @@
 #include "Profiler.h"
 #include "Table.h"
 #include "Row.h"
+#include "JoinResult.h"
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 enum class JoinType {
     INNER,
@@ -12,16 +15,99 @@ enum class JoinType {
     FULL_OUTER
 };
 
+// how the hashed join paths lay out the build side
+enum class JoinAlgorithm {
+    // one hash table over the whole build side, probed in row order
+    NO_PARTITIONING,
+    // both sides radix-partitioned on hash bits first, so each partition's
+    // table fits in cache while it is built and probed
+    RADIX
+};
+
+struct JoinOptions {
+    // threads used for the build phase; above 1 the build side goes into a
+    // ConcurrentHashTable (lock-free chaining) and the strategy is ignored
+    size_t buildThreads = 1;
+    // build a Bloom filter over the build keys and check it before each probe;
+    // pays off when most probe rows have no match
+    bool useBloomFilter = false;
+    // probe keys looked up per group: each group is hashed and prefetched
+    // before any of it is resolved, hiding cache misses on large build
+    // tables. 0 or 1 keeps the one-key-at-a-time loop.
+    size_t probeBatchSize = 0;
+    // two-pass build into a CsrHashTable: distinct keys go into the hash
+    // table (with the chosen strategy), row ids into one array grouped by
+    // key. Best for low-cardinality keys; single-threaded builds only.
+    bool csrBuild = false;
+    // when the build keys are non-NULL INTEGERs over a dense range, index
+    // them by value in a DirectAddressTable instead of hashing; falls back to
+    // the paths above otherwise
+    bool directAddressing = true;
+    // when both join columns are dictionary-encoded (Table::encodeColumn),
+    // join on their 32-bit codes instead of the strings
+    bool dictionaryCodes = true;
+    // RADIX replaces the hash table, CSR and concurrent builds (strategy,
+    // csrBuild, buildThreads, useBloomFilter and probeBatchSize are then
+    // ignored); a direct array still wins when the keys allow it
+    JoinAlgorithm algorithm = JoinAlgorithm::NO_PARTITIONING;
+    // radix bits for RADIX (2^bits partitions, 0 for one); negative sizes
+    // the partitions to fit the cache
+    int radixBits = -1;
+    // HashFunctionFactory type used for the hashed paths (e.g. "xxh3",
+    // "wyhash"); empty picks TypedValueHasher for the join column's type
+    std::string hashFunction;
+    // bytes the build side may take in memory, estimated from its row count
+    // and key sizes; above it both inputs are hash-partitioned into spill
+    // files and joined one partition pair at a time (Grace hash join),
+    // re-partitioning pairs that are still too large. Budgets under a few
+    // KB act as that floor. 0 means no limit.
+    size_t memoryBudget = 0;
+    // where spill files go; empty uses the system temp directory
+    std::string spillDirectory;
+};
+
 class JoinEngine {
     private:
         Profiler profiler_;
 
+        static constexpr uint32_t CUCKOO_ALT_SEED = 0x9747b28c;
+
+        // Grace hash join limits: partitions per level, and levels before a
+        // partition is joined in memory whatever its size
+        static constexpr size_t MAX_SPILL_FANOUT = 64;
+        static constexpr size_t MAX_SPILL_DEPTH = 4;
+        // budget floor: a build side this small joins in memory, since
+        // spilling it would only trade a few KB for a file per partition
+        static constexpr size_t SPILL_MIN_BUILD_BYTES = 4 * 1024;
+        // partitioning hash seed, plus the level; independent of the seeds the
+        // partition joins hash with
+        static constexpr uint64_t SPILL_SEED = 0x5bd1e995;
+        // rough in-memory cost of one build row (key, hash, row id, slot
+        // overhead), not counting string key bytes
+        static constexpr size_t BUILD_BYTES_PER_ROW = 96;
+
+        // partition level this engine joins at; 0 for a top-level join
+        size_t spillDepth_ = 0;
+        // set for partition joins, so they build on the same side as the
+        // join they belong to (outer joins emit unmatched build rows)
+        std::optional<bool> buildLeft_;
+
         // choose which table should be built vs probe based on size
         std::pair<const Table*, const Table*> chooseBuildProbe(const Table& left, const Table& right); 
 
-        Row combineRows(const Row& left, const Row& right);
+        // the join proper: builds, probes and records row id pairs. Starts
+        // profiling; the caller records the results and stops it.
+        JoinResult joinRowIds(const Table& leftTable, const std::string& leftColumn,
+                              const Table& rightTable, const std::string& rightColumn,
+                              JoinType joinType, CollisionStrategy strategy, const JoinOptions& options);
 
-        Row createNullRow(size_t columnCount);
+        // joinRowIds over the memory budget: spills both sides' keys into
+        // partitions and joins each pair with a nested engine
+        template<typename LoadBuildKey, typename LoadProbeKey>
+        JoinResult graceJoin(const Table& leftTable, const Table& rightTable, bool leftIsBuild,
+                             DataType buildKeyType, DataType probeKeyType, size_t buildBytes,
+                             LoadBuildKey&& loadBuildKey, LoadProbeKey&& loadProbeKey,
+                             JoinType joinType, CollisionStrategy strategy, const JoinOptions& options);
 
     public:
         std::unique_ptr<Table> hashJoin(
@@ -30,8 +116,37 @@ class JoinEngine {
         const Table& rightTable, 
         const std::string& rightColumn,
         JoinType joinType = JoinType::INNER,
-        CollisionStrategy strategy = CollisionStrategy::CHAINING
+        CollisionStrategy strategy = CollisionStrategy::CHAINING,
+        const JoinOptions& options = JoinOptions{}
+    );
+
+    // projected join: the result holds only the listed columns ("L_<name>"
+    // / "R_<name>", optionally renamed), in that order, and no other column
+    // of either input is read. An empty list outputs every column.
+    std::unique_ptr<Table> hashJoin(
+        const Table& leftTable,
+        const std::string& leftColumn,
+        const Table& rightTable,
+        const std::string& rightColumn,
+        const std::vector<OutputColumn>& output,
+        JoinType joinType = JoinType::INNER,
+        CollisionStrategy strategy = CollisionStrategy::CHAINING,
+        const JoinOptions& options = JoinOptions{}
+    );
+
+    // same join, but the output stays as (left row, right row) id pairs with
+    // JoinResult::NULL_ROW for outer-join NULLs; columns are copied only
+    // when read from the JoinResult. Both tables must outlive it.
+    JoinResult hashJoinRowIds(
+        const Table& leftTable,
+        const std::string& leftColumn,
+        const Table& rightTable,
+        const std::string& rightColumn,
+        JoinType joinType = JoinType::INNER,
+        CollisionStrategy strategy = CollisionStrategy::CHAINING,
+        const JoinOptions& options = JoinOptions{}
     );
 
     const Profiler& getProfiler() const;
+    Profiler& getProfiler();
 };
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "Table.h"
+
+// one output row of a join: a row id into each input, NULL_ROW for the
+// missing side of an outer-join row
+struct RowIdPair {
+    uint32_t left;
+    uint32_t right;
+};
+
+// one column of a projected join output: a result column name ("L_<name>"
+// or "R_<name>") and the name to give it, the same name when alias is empty
+struct OutputColumn {
+    std::string column;
+    std::string alias;
+
+    OutputColumn(std::string column, std::string alias = "")
+        : column(std::move(column)), alias(std::move(alias)) {}
+    OutputColumn(const char* column) : column(column) {}
+};
+
+// Join output kept as row id pairs into the two input tables, 8 bytes per
+// row however wide the inputs are. Cells are copied out only when asked
+// for, one requested column at a time: materialize() gathers a row range
+// into a Table, forEachBatch() walks the result a batch at a time. The
+// output columns are the left table's columns then the right table's,
+// named "L_<name>" and "R_<name>" as in JoinEngine::hashJoin.
+//
+// Only pointers to the inputs are kept; they must outlive the result.
+class JoinResult {
+    private:
+        const Table* left_;
+        const Table* right_;
+        TrackedVector<RowIdPair, MemoryComponent::JOIN> rows_;
+
+        // output column -> (input table, column in it)
+        std::pair<const Table*, size_t> sourceOf(size_t column) const;
+        std::vector<size_t> resolveColumns(const std::vector<OutputColumn>& columns) const;
+
+    public:
+        static constexpr uint32_t NULL_ROW = UINT32_MAX;
+
+        JoinResult(const Table& left, const Table& right);
+
+        void add(size_t leftRow, size_t rightRow) {
+            rows_.push_back({static_cast<uint32_t>(leftRow), static_cast<uint32_t>(rightRow)});
+        }
+        void reserve(size_t rows) { rows_.reserve(rows); }
+
+        size_t rowCount() const { return rows_.size(); }
+        size_t columnCount() const { return left_->columnCount() + right_->columnCount(); }
+        const TrackedVector<RowIdPair, MemoryComponent::JOIN>& getRowIds() const { return rows_; }
+        const Table& getLeft() const { return *left_; }
+        const Table& getRight() const { return *right_; }
+
+        std::string getColumnName(size_t column) const;
+        std::optional<size_t> getColumnIndex(const std::string& name) const;
+
+        // one cell, read through the row ids
+        Value getValue(size_t row, size_t column) const;
+
+        // copies the named output columns (all of them when empty) of rows
+        // [begin, end) into a new Table, under their aliases; throws for an
+        // unknown name
+        std::unique_ptr<Table> materialize(const std::vector<OutputColumn>& columns = {},
+                                           size_t begin = 0, size_t end = SIZE_MAX) const;
+
+        // calls callback(batch, firstRow) for consecutive batches of at most
+        // batchSize rows, each holding just the named columns
+        template<typename Callback>
+        void forEachBatch(const std::vector<OutputColumn>& columns, size_t batchSize, Callback&& callback) const {
+            batchSize = std::max<size_t>(batchSize, 1);
+            for (size_t begin = 0; begin < rows_.size(); begin += batchSize) {
+                auto batch = materialize(columns, begin, std::min(rows_.size(), begin + batchSize));
+                callback(static_cast<const Table&>(*batch), begin);
+            }
+        }
+
+        size_t memoryUsage() const {
+            return sizeof(*this) + rows_.capacity() * sizeof(RowIdPair);
+        }
+};
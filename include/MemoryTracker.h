@@ -0,0 +1,103 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// what a tracked allocation belongs to
+enum class MemoryComponent {
+    TABLE,      // column arrays and string dictionaries
+    ROW,        // materialized Rows
+    HASH_TABLE, // lookup structures built for a join
+    JOIN        // join bookkeeping: matched flags, row id results, probe buffers
+};
+
+constexpr size_t MEMORY_COMPONENT_COUNT = 4;
+
+const char* memoryComponentName(MemoryComponent component);
+
+struct MemoryCounters {
+    size_t current = 0;     // bytes live now
+    size_t peak = 0;        // most bytes live at once since the last resetPeaks()
+    size_t allocations = 0; // allocations made so far
+};
+
+// Process-wide byte counts of the allocations made through TrackingAllocator
+// (and Arena), per component and in total. Counters are relaxed atomics, so
+// any thread may allocate; reading several counters while other threads
+// allocate does not give a consistent snapshot.
+class MemoryTracker {
+    private:
+        struct Slot {
+            std::atomic<size_t> current{0};
+            std::atomic<size_t> peak{0};
+            std::atomic<size_t> allocations{0};
+        };
+
+        // one per component, then the total
+        static Slot slots_[MEMORY_COMPONENT_COUNT + 1];
+
+        static void add(Slot& slot, size_t bytes) {
+            size_t now = slot.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+            slot.allocations.fetch_add(1, std::memory_order_relaxed);
+            size_t peak = slot.peak.load(std::memory_order_relaxed);
+            while (now > peak && !slot.peak.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+            }
+        }
+
+        static MemoryCounters read(const Slot& slot);
+
+    public:
+        static void allocated(MemoryComponent component, size_t bytes) {
+            add(slots_[static_cast<size_t>(component)], bytes);
+            add(slots_[MEMORY_COMPONENT_COUNT], bytes);
+        }
+
+        static void released(MemoryComponent component, size_t bytes) {
+            slots_[static_cast<size_t>(component)].current.fetch_sub(bytes, std::memory_order_relaxed);
+            slots_[MEMORY_COMPONENT_COUNT].current.fetch_sub(bytes, std::memory_order_relaxed);
+        }
+
+        static MemoryCounters counters(MemoryComponent component);
+        static MemoryCounters total();
+
+        // starts a new peak window: every peak drops to the current value
+        static void resetPeaks();
+};
+
+// std::allocator that reports its bytes to MemoryTracker under Component.
+// Stateless, so containers using it are as small and as fast to move as
+// with the default allocator.
+template<typename T, MemoryComponent Component>
+class TrackingAllocator {
+    public:
+        using value_type = T;
+
+        template<typename U>
+        struct rebind {
+            using other = TrackingAllocator<U, Component>;
+        };
+
+        TrackingAllocator() noexcept = default;
+        template<typename U>
+        TrackingAllocator(const TrackingAllocator<U, Component>&) noexcept {}
+
+        T* allocate(size_t n) {
+            T* p = std::allocator<T>().allocate(n);
+            MemoryTracker::allocated(Component, n * sizeof(T));
+            return p;
+        }
+
+        void deallocate(T* p, size_t n) noexcept {
+            MemoryTracker::released(Component, n * sizeof(T));
+            std::allocator<T>().deallocate(p, n);
+        }
+
+        template<typename U>
+        bool operator==(const TrackingAllocator<U, Component>&) const noexcept { return true; }
+        template<typename U>
+        bool operator!=(const TrackingAllocator<U, Component>&) const noexcept { return false; }
+};
+
+template<typename T, MemoryComponent Component>
+using TrackedVector = std::vector<T, TrackingAllocator<T, Component>>;
@@ -1,18 +1,48 @@
 // to generate profile for the entire join operation
 #pragma once
 #include <chrono>
+#include <string>
 #include "CustomHashTable.h"
+#include "MemoryTracker.h"
 class Profiler{
     public:
+        enum MemoryPhase { BUILD_PHASE, PROBE_PHASE, MATERIALIZE_PHASE, MEMORY_PHASE_COUNT };
+
+        // tracked allocations (MemoryTracker) of one component in one join
+        // phase; bytes count from what was live when the join started
+        struct PhaseMemory {
+            size_t peakBytes = 0;   // most bytes live at once during the phase
+            long long netBytes = 0; // live at the end of the phase
+            size_t allocations = 0; // allocations made during the phase
+        };
+
         struct ProfileData {
             std::chrono::nanoseconds buildTime{0};
             std::chrono::nanoseconds probeTime{0};
+            // copying result columns out of the inputs; 0 for row id results
+            std::chrono::nanoseconds materializeTime{0};
             std::chrono::nanoseconds totalTime{0};
-            size_t memoryUsage = 0;
-            size_t peakMemoryUsage = 0;
+            size_t memoryUsage = 0;     // the lookup structure's own estimate
+            size_t peakMemoryUsage = 0; // most tracked bytes the join had live at once
+            // [phase][component], the last component being all of them
+            PhaseMemory memory[MEMORY_PHASE_COUNT][MEMORY_COMPONENT_COUNT + 1];
+            std::string joinPath; // which build structure the join used, and why
+            size_t buildThreads = 1;
             HashTableStats hashStats;
+            DetailedHashTableStats detailedHashStats;
+            bool hasDetailedHashStats = false;
             size_t resultRows = 0;
             double selectivity = 0.0;
+            // Bloom filter checked before each probe (JoinOptions::useBloomFilter)
+            bool usedBloomFilter = false;
+            size_t filterProbes = 0;         // probe rows checked against the filter
+            size_t filterPasses = 0;         // ... that went on to the hash table
+            size_t filterFalsePositives = 0; // ... and then found no match
+            size_t filterMemory = 0;
+            // Grace hash join (JoinOptions::memoryBudget), over all levels
+            size_t spillPartitions = 0; // partitions written
+            size_t spillBytes = 0;      // bytes written to spill files
+            size_t spillDepth = 0;      // deepest partitioning level
         };
 
         void startProfiling();
@@ -21,8 +51,30 @@ class Profiler{
 
         void markProbeComplete();
 
+        void markMaterializeComplete();
+
         void recordHashStats(const HashTableStats& stats);
 
+        void recordBuildThreads(size_t threads);
+
+        void recordJoinPath(const std::string& path);
+
+        // histograms need a full table walk, so they are opt-in
+        void setDetailedStats(bool enabled);
+
+        bool wantsDetailedStats() const;
+
+        void recordDetailedStats(const DetailedHashTableStats& stats);
+
+        void recordFilterStats(size_t probes, size_t passes, size_t falsePositives, size_t memory);
+
+        // accumulates: a Grace join records each level it partitions
+        void recordSpill(size_t partitions, size_t bytes, size_t depth);
+
+        // a nested profiler (a partition join inside a Grace join) leaves the
+        // tracker's peak window to the outer one
+        void setNested(bool nested);
+
         void recordResults(size_t resultRows, size_t totalPossibleRows);
 
         void stopProfiling();
@@ -33,6 +85,14 @@ class Profiler{
 
     private:
         std::chrono::high_resolution_clock::time_point startTime_;
+        // tracker counters when the join and the current phase started
+        MemoryCounters joinStart_[MEMORY_COMPONENT_COUNT + 1];
+        MemoryCounters phaseStart_[MEMORY_COMPONENT_COUNT + 1];
         ProfileData data_;
         bool profiling_ = false;
+        bool detailedStats_ = false;
+        bool nested_ = false;
+
+        static void readTracker(MemoryCounters* counters);
+        void recordMemoryPhase(MemoryPhase phase);
 };
\ No newline at end of file
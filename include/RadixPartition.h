@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include "MemoryTracker.h"
+
+// one input row of a radix join, 16 bytes so four share a cache line
+struct RadixTuple {
+    int64_t key;   // the join key for integer joins, otherwise the full hash
+    uint32_t row;  // row id in the input table
+    uint32_t hash; // low bits pick the partition, the bits above the bucket
+};
+
+// Tuples reordered by the low bits of their hash into 2^bits contiguous
+// partitions. Each pass splits every partition by at most MAX_BITS_PER_PASS
+// more bits, so the tuples being written go to few enough places at once
+// to stay within the TLB and the cache; writes go through a cache-line
+// buffer per partition (software write-combining).
+class RadixPartitions {
+    public:
+        using Tuples = TrackedVector<RadixTuple, MemoryComponent::HASH_TABLE>;
+
+        static constexpr unsigned MAX_BITS_PER_PASS = 8;
+        static constexpr unsigned MAX_BITS = 16;
+        // per-partition build side target: a typical L2
+        static constexpr size_t CACHE_BYTES = 256 * 1024;
+        // a build tuple plus its RadixBucketTable head and chain link
+        static constexpr size_t BUILD_BYTES_PER_TUPLE = sizeof(RadixTuple) + 2 * sizeof(uint32_t);
+
+        // fewest bits that bring an even partition of the build side under
+        // CACHE_BYTES, capped at MAX_BITS
+        static unsigned bitsFor(size_t buildRows);
+
+        // bits above MAX_BITS are capped; 0 leaves a single partition
+        RadixPartitions(Tuples tuples, unsigned bits);
+
+        unsigned bits() const { return bits_; }
+        unsigned passes() const { return passes_; }
+        size_t partitionCount() const { return offsets_.size() - 1; }
+        const RadixTuple* partition(size_t p) const { return tuples_.data() + offsets_[p]; }
+        size_t partitionSize(size_t p) const { return offsets_[p + 1] - offsets_[p]; }
+        size_t memoryUsage() const {
+            return tuples_.capacity() * sizeof(RadixTuple) + offsets_.capacity() * sizeof(size_t);
+        }
+
+    private:
+        Tuples tuples_;
+        TrackedVector<size_t, MemoryComponent::HASH_TABLE> offsets_; // partitionCount + 1 bounds
+        unsigned bits_;
+        unsigned passes_;
+
+        // one pass over n tuples: out holds them grouped by
+        // (hash >> shift) & (2^bits - 1); bounds gets the 2^bits + 1
+        // partition bounds relative to out
+        static void scatter(const RadixTuple* in, size_t n, RadixTuple* out,
+                            unsigned shift, unsigned bits, size_t* bounds);
+};
+
+// Bucket-chained hash table over one build partition, rebuilt for each
+// partition in the same arrays. Buckets use the hash bits above the radix
+// bits, which are all equal within a partition.
+class RadixBucketTable {
+    private:
+        TrackedVector<uint32_t, MemoryComponent::HASH_TABLE> heads_; // tuple index + 1, 0 ends a chain
+        TrackedVector<uint32_t, MemoryComponent::HASH_TABLE> next_;
+        const RadixTuple* tuples_ = nullptr;
+        unsigned shift_ = 0;
+        size_t mask_ = 0;
+        size_t usedBuckets_ = 0;
+
+    public:
+        // a power of two buckets, at least one per tuple
+        void build(const RadixTuple* tuples, size_t count, unsigned radixBits);
+
+        // f(tuple) for each build tuple in hash's bucket, in row order; the
+        // caller compares keys
+        template<typename F>
+        void forEachCandidate(uint32_t hash, F&& f) const {
+            for (uint32_t i = heads_[(hash >> shift_) & mask_]; i != 0; i = next_[i - 1]) {
+                f(tuples_[i - 1]);
+            }
+        }
+
+        size_t bucketCount() const { return mask_ + 1; }
+        size_t usedBuckets() const { return usedBuckets_; }
+        size_t memoryUsage() const {
+            return heads_.capacity() * sizeof(uint32_t) + next_.capacity() * sizeof(uint32_t);
+        }
+};
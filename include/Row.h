@@ -1,19 +1,23 @@
 #pragma once
 #include <vector>
+#include "MemoryTracker.h"
 #include "Value.h"
 
 class Row {
+public:
+    using Values = TrackedVector<Value, MemoryComponent::ROW>;
+
 private:
-    std::vector<Value> values_;
+    Values values_;
 
 public:
     Row() = default;
-    Row(std::vector<Value> values) : values_(std::move(values)) {}
+    Row(Values values) : values_(std::move(values)) {}
     
     void addValue(const Value& value);
     size_t size() const;
     const Value& getValue(size_t index) const;
     std::string toString() const;    const Value& operator[](size_t index) const;
     Value& operator[](size_t index);
-    const std::vector<Value>& getValues() const { return values_; }
+    const Values& getValues() const { return values_; }
 };
\ No newline at end of file
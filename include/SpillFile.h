@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include "Table.h"
+
+// Append-only file of (row id, join key) records on local disk: one side of
+// one partition of a Grace hash join. Only the keys are spilled; the rest of
+// each row stays in its input table and is found again through the row id.
+// The file is removed when the SpillFile is destroyed.
+class SpillFile {
+    private:
+        std::string path_;
+        DataType keyType_;
+        std::ofstream out_;
+        size_t rowCount_ = 0;
+        size_t bytesWritten_ = 0;
+
+    public:
+        // a new file in directory for keys of keyType; throws if it can't be
+        // created
+        SpillFile(const std::string& directory, DataType keyType);
+        ~SpillFile();
+
+        SpillFile(const SpillFile&) = delete;
+        SpillFile& operator=(const SpillFile&) = delete;
+
+        void append(uint32_t row, const Value& key);
+
+        // the records as a table with a "key" column (of the key type) and a
+        // "row" column (INTEGER); no more appends after this
+        std::unique_ptr<Table> readTable(const std::string& name);
+
+        size_t rowCount() const { return rowCount_; }
+        size_t bytesWritten() const { return bytesWritten_; }
+        const std::string& path() const { return path_; }
+};
@@ -1,9 +1,13 @@
 #pragma once
+#include <cstddef>
+#include <iterator>
+#include <memory>
 #include <vector>
 #include <string>
 #include <optional>
 #include "Value.h"
 #include "Row.h"
+#include "Column.h"
 
 struct ColumnInfo {
     std::string name;
@@ -11,35 +15,119 @@ struct ColumnInfo {
     size_t index;
 };
 
+class Table;
+
+// Read-only view of one row of a Table. Cells are read out of the columns
+// on access, so a view is two words and copying one allocates nothing;
+// converts to a Row where a materialized copy is needed.
+class RowView {
+private:
+    const Table* table_;
+    size_t index_;
+
+public:
+    RowView(const Table& table, size_t index) : table_(&table), index_(index) {}
+
+    size_t size() const;
+    size_t index() const { return index_; }
+    Value getValue(size_t column) const;
+    Value operator[](size_t column) const { return getValue(column); }
+    std::string toString() const;
+    Row::Values getValues() const;
+    Row toRow() const;
+    operator Row() const { return toRow(); }
+};
+
+// The rows of a Table as RowViews, so code written against the row store
+// keeps working: for (const auto& row : table.getRows()), getRows()[i] and
+// getRows().size().
+class RowRange {
+private:
+    const Table* table_;
+
+public:
+    class iterator {
+    private:
+        const Table* table_;
+        size_t index_;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = RowView;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = RowView;
+
+        iterator(const Table* table, size_t index) : table_(table), index_(index) {}
+
+        RowView operator*() const { return RowView(*table_, index_); }
+        iterator& operator++() { ++index_; return *this; }
+        iterator operator++(int) { iterator old = *this; ++index_; return old; }
+        bool operator==(const iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const iterator& other) const { return index_ != other.index_; }
+    };
+
+    explicit RowRange(const Table& table) : table_(&table) {}
+
+    iterator begin() const { return iterator(table_, 0); }
+    iterator end() const { return iterator(table_, size()); }
+    size_t size() const;
+    bool empty() const { return size() == 0; }
+    RowView operator[](size_t index) const { return RowView(*table_, index); }
+};
+
 class Table {
 /*
            col_1 | col_2 | col_3
  (row1)    val1  | val2  | val3
  (row2)    val1  | val2  | val3
  (row3)    val1  | val2  | val3
+
+ stored column by column: see Column
 */
 private:
     std::vector<ColumnInfo> schema_;
-    std::vector<Row> rows_;
+    std::vector<Column> columns_;
+    size_t rowCount_ = 0;
     std::string name_;
 
 public:
     Table(const std::string& name) : name_(name) {}
 
-    void addColumn(const std::string& name, DataType type) {
-        schema_.push_back({name, type, schema_.size()});
-    }
+    // rows already in the table get NULL in the new column
+    void addColumn(const std::string& name, DataType type);
+    // adds a filled column; its size must match the rows already in the
+    // table (any size for the first column)
+    void addColumn(const std::string& name, Column column);
 
+    // a cell the column's type can't hold is converted where that is exact
+    // (INTEGER <-> DOUBLE) and stored as NULL otherwise
     void addRow(const Row& row);
-    const Row& getRow(size_t index) const;
+    RowView getRow(size_t index) const;
+    RowRange getRows() const { return RowRange(*this); }
+    const Column& getColumn(size_t index) const { return columns_[index]; }
+    // dictionary-encodes a STRING column, into dictionary when given (e.g.
+    // one shared with the other side of a join), else a new one
+    void encodeColumn(size_t index, std::shared_ptr<StringDictionary> dictionary = nullptr);
+    // compresses every INTEGER column that gets smaller (Column::compress);
+    // meant for a table that is done loading
+    void compressColumns();
+    void reserve(size_t rows);
     size_t rowCount() const;
     size_t columnCount() const;
     const std::vector<ColumnInfo>& getSchema() const;
-    const std::vector<Row>& getRows() const;
     const std::string& getName() const;
     std::optional<size_t> getColumnIndex(const std::string& colName) const;
     size_t estimateMemoryUsage() const;
     void clear();
     void printSchema() const;
     void printSample(size_t maxRows = 5) const;
+
+    // writes the table to a binary snapshot file (layout in
+    // table_snapshot.cpp); throws if the file can't be written
+    void saveSnapshot(const std::string& path) const;
+    // maps a snapshot file read-only; the columns are served straight from
+    // the mapping, copied only if the table is changed later. Throws for a
+    // missing or corrupt file
+    static std::unique_ptr<Table> openSnapshot(const std::string& path);
 };
\ No newline at end of file
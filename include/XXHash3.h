@@ -0,0 +1,7 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// XXH3 64-bit (xxHash 0.8) with its default secret, scalar code path. Output
+// matches the reference XXH3_64bits_withSeed for every input length.
+uint64_t xxh3Hash64(const void* data, size_t length, uint64_t seed);
@@ -0,0 +1,34 @@
+#include "Arena.h"
+#include <algorithm>
+
+Arena::Arena(size_t firstBlockSize, MemoryComponent component)
+    : nextBlockSize_(std::max(firstBlockSize, MIN_BLOCK_SIZE)), component_(component) {}
+
+void Arena::addBlock(size_t minBytes) {
+    // blocks double up to MAX_BLOCK_SIZE, so a large build costs a handful
+    // of allocations rather than one per object
+    size_t size = std::max(nextBlockSize_, minBytes);
+    nextBlockSize_ = std::min(nextBlockSize_ * 2, MAX_BLOCK_SIZE);
+
+    Block block{std::unique_ptr<char[], BlockDeleter>(new char[size], BlockDeleter{component_, size}), size};
+    MemoryTracker::allocated(component_, size);
+    cursor_ = block.data.get();
+    limit_ = cursor_ + size;
+    bytesReserved_ += size;
+    blocks_.push_back(std::move(block));
+}
+
+void Arena::reset() {
+    if (blocks_.empty()) {
+        return;
+    }
+    auto largest = std::max_element(blocks_.begin(), blocks_.end(),
+        [](const Block& a, const Block& b) { return a.size < b.size; });
+    Block kept = std::move(*largest);
+    blocks_.clear();
+
+    cursor_ = kept.data.get();
+    limit_ = cursor_ + kept.size;
+    bytesReserved_ = kept.size;
+    blocks_.push_back(std::move(kept));
+}
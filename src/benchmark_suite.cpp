@@ -1,16 +1,25 @@
 #include "BenchmarkSuite.h"
 #include "DataLoader.h"
 #include "JoinEngine.h"
+#include "HashFunction.h"
+#include "RadixPartition.h"
 #include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <random>
 
 Profiler::ProfileData BenchmarkSuite::benchmarkJoinWithStrategy(size_t tableSize, CollisionStrategy strategy) {
         DataLoader loader;
         auto leftTable = loader.generateTestTable("Left", tableSize, 42);
         auto rightTable = loader.generateTestTable("Right", tableSize / 2, 123);
         
+        // "value" is a dense integer range; keep it on the hash table being compared
+        JoinOptions options;
+        options.directAddressing = false;
+
         JoinEngine engine;
         auto result = engine.hashJoin(*leftTable, "value", *rightTable, "value", 
-                                     JoinType::INNER, strategy);
+                                     JoinType::INNER, strategy, options);
         
         return engine.getProfiler().getData();
     }
@@ -21,7 +30,10 @@ void BenchmarkSuite::runHashTableBenchmark() {
         const std::vector<size_t> sizes = {1000, 10000, 100000};
         const std::vector<CollisionStrategy> strategies = {
             CollisionStrategy::CHAINING,
-            CollisionStrategy::LINEAR_PROBING
+            CollisionStrategy::LINEAR_PROBING,
+            CollisionStrategy::SWISS,
+            CollisionStrategy::ROBIN_HOOD,
+            CollisionStrategy::CUCKOO
         };
         
         for (size_t tableSize : sizes) {
@@ -31,14 +43,15 @@ void BenchmarkSuite::runHashTableBenchmark() {
                       << std::setw(15) << "Probe (ms)"
                       << std::setw(15) << "Total (ms)"
                       << std::setw(15) << "Load Factor"
-                      << std::setw(15) << "Collisions\n";
-            std::cout << std::string(95, '-') << "\n";
+                      << std::setw(15) << "Collisions"
+                      << std::setw(15) << "Avg Probe"
+                      << std::setw(15) << "Max Probe\n";
+            std::cout << std::string(125, '-') << "\n";
             
             for (auto strategy : strategies) {
                 auto result = benchmarkJoinWithStrategy(tableSize, strategy);
                 
-                std::string strategyName = (strategy == CollisionStrategy::CHAINING) ? 
-                    "Chaining" : "Linear Probing";
+                std::string strategyName = collisionStrategyName(strategy);
                 
                 std::cout << std::setw(20) << strategyName
                           << std::setw(15) << std::fixed << std::setprecision(2)
@@ -46,7 +59,9 @@ void BenchmarkSuite::runHashTableBenchmark() {
                           << std::setw(15) << result.probeTime.count() / 1e6
                           << std::setw(15) << result.totalTime.count() / 1e6
                           << std::setw(15) << std::setprecision(3) << result.hashStats.loadFactor
-                          << std::setw(15) << result.hashStats.collisions << "\n";
+                          << std::setw(15) << result.hashStats.collisions
+                          << std::setw(15) << result.hashStats.avgProbeDistance
+                          << std::setw(15) << result.hashStats.maxProbeDistance << "\n";
             }
         }
     }
@@ -98,7 +113,7 @@ void BenchmarkSuite::runScalabilityBenchmark() {
         std::cout << std::setw(12) << "Left Size"
                   << std::setw(12) << "Right Size"
                   << std::setw(15) << "Total (ms)"
-                  << std::setw(15) << "Memory (KB)"
+                  << std::setw(15) << "Peak Mem (KB)"
                   << std::setw(15) << "Result Rows"
                   << std::setw(15) << "Throughput\n";
         std::cout << std::string(84, '-') << "\n";
@@ -121,10 +136,349 @@ void BenchmarkSuite::runScalabilityBenchmark() {
                           << std::setw(12) << rightSize
                           << std::setw(15) << std::fixed << std::setprecision(2)
                           << profilerData.totalTime.count() / 1e6
-                          << std::setw(15) << profilerData.memoryUsage / 1024
+                          << std::setw(15) << profilerData.peakMemoryUsage / 1024
                           << std::setw(15) << profilerData.resultRows
                           << std::setw(15) << std::setprecision(0) << throughputRowsPerMs << "\n";
             }
         }
     }
 
+
+void BenchmarkSuite::runProbeLatencyBenchmark() {
+        std::cout << "\n=== Probe Latency Distribution ===\n";
+
+        const size_t buildSize = 100000;
+        const size_t probeCount = 200000; // ids past buildSize miss
+        const std::vector<CollisionStrategy> strategies = {
+            CollisionStrategy::CHAINING,
+            CollisionStrategy::LINEAR_PROBING,
+            CollisionStrategy::SWISS,
+            CollisionStrategy::ROBIN_HOOD,
+            CollisionStrategy::CUCKOO
+        };
+
+        DataLoader loader;
+        auto buildTable = loader.generateTestTable("Build", buildSize, 42);
+        const size_t keyCol = *buildTable->getColumnIndex("id");
+
+        std::vector<Value> probeKeys;
+        probeKeys.reserve(probeCount);
+        srand(7);
+        for (size_t i = 0; i < probeCount; ++i) {
+            probeKeys.push_back(Value(static_cast<std::int64_t>(rand() % (2 * buildSize) + 1)));
+        }
+
+        std::cout << "Build rows: " << buildSize << ", probes: " << probeCount << " (about half miss)\n";
+        std::cout << std::setw(20) << "Strategy"
+                  << std::setw(15) << "p50 (ns)"
+                  << std::setw(15) << "p99 (ns)"
+                  << std::setw(15) << "Max (ns)"
+                  << std::setw(15) << "Max Probe\n";
+        std::cout << std::string(80, '-') << "\n";
+
+        for (auto strategy : strategies) {
+            CustomHashTable<Value, size_t, MurmurValueHasher> table(
+                CustomHashTable<Value, size_t, MurmurValueHasher>::capacityFor(buildSize),
+                strategy, MurmurValueHasher(), MurmurValueHasher(0x9747b28c));
+            for (size_t i = 0; i < buildTable->rowCount(); ++i) {
+                table.insert(buildTable->getColumn(keyCol).valueAt(i), i);
+            }
+
+            // timed one probe at a time; clock overhead is included in every
+            // sample, equally for all strategies
+            std::vector<long long> samples;
+            samples.reserve(probeCount);
+            size_t sink = 0;
+            for (const auto& key : probeKeys) {
+                auto start = std::chrono::steady_clock::now();
+                sink += table.forEachMatch(key, [](size_t) {});
+                auto end = std::chrono::steady_clock::now();
+                samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+            }
+            std::sort(samples.begin(), samples.end());
+
+            std::cout << std::setw(20) << collisionStrategyName(strategy)
+                      << std::setw(15) << samples[samples.size() / 2]
+                      << std::setw(15) << samples[samples.size() * 99 / 100]
+                      << std::setw(15) << samples.back()
+                      << std::setw(15) << table.getStats().maxProbeDistance << "\n";
+            if (sink == 0) std::cout << "(no matches)\n";
+        }
+    }
+
+void BenchmarkSuite::runBatchedProbeBenchmark() {
+        std::cout << "\n=== Batched (Group Prefetch) Probe vs Scalar Loop ===\n";
+
+        // big enough that the tables do not fit in a typical last-level cache
+        const size_t buildSize = 1 << 20;
+        const size_t probeCount = 2 * buildSize; // about half miss
+        const std::vector<size_t> batchSizes = {1, 16, 32, 64};
+        const std::vector<CollisionStrategy> strategies = {
+            CollisionStrategy::CHAINING,
+            CollisionStrategy::LINEAR_PROBING,
+            CollisionStrategy::SWISS,
+            CollisionStrategy::ROBIN_HOOD,
+            CollisionStrategy::CUCKOO
+        };
+
+        std::vector<Value> probeKeys;
+        probeKeys.reserve(probeCount);
+        srand(11);
+        for (size_t i = 0; i < probeCount; ++i) {
+            probeKeys.push_back(Value(static_cast<std::int64_t>(rand() % (2 * buildSize) + 1)));
+        }
+
+        std::cout << "Build keys: " << buildSize << ", probes: " << probeCount << "\n";
+        std::cout << std::setw(20) << "Strategy";
+        for (size_t batch : batchSizes) {
+            std::cout << std::setw(15) << (batch == 1 ? std::string("Scalar ns/key") : "Batch " + std::to_string(batch));
+        }
+        std::cout << std::setw(15) << "Best Speedup\n";
+        std::cout << std::string(20 + 15 * (batchSizes.size() + 1), '-') << "\n";
+
+        for (auto strategy : strategies) {
+            CustomHashTable<Value, size_t, MurmurValueHasher> table(
+                CustomHashTable<Value, size_t, MurmurValueHasher>::capacityFor(buildSize),
+                strategy, MurmurValueHasher(), MurmurValueHasher(0x9747b28c));
+            for (size_t i = 0; i < buildSize; ++i) {
+                table.insert(Value(static_cast<std::int64_t>(i + 1)), i);
+            }
+
+            std::cout << std::setw(20) << collisionStrategyName(strategy)
+                      << std::fixed << std::setprecision(2);
+            double scalarNs = 0.0;
+            double bestNs = 0.0;
+            size_t sink = 0;
+            for (size_t batch : batchSizes) {
+                // same pipeline as JoinEngine with JoinOptions::probeBatchSize
+                std::vector<size_t> hashes(batch);
+                auto start = std::chrono::steady_clock::now();
+                for (size_t base = 0; base < probeCount; base += batch) {
+                    size_t count = std::min(batch, probeCount - base);
+                    if (batch == 1) {
+                        sink += table.forEachMatch(probeKeys[base], [](size_t) {});
+                        continue;
+                    }
+                    for (size_t i = 0; i < count; ++i) {
+                        hashes[i] = table.hashOf(probeKeys[base + i]);
+                        table.prefetchBucket(hashes[i]);
+                    }
+                    for (size_t i = 0; i < count; ++i) {
+                        table.prefetchEntry(hashes[i]);
+                    }
+                    for (size_t i = 0; i < count; ++i) {
+                        sink += table.forEachMatchHashed(probeKeys[base + i], hashes[i], [](size_t) {});
+                    }
+                }
+                auto end = std::chrono::steady_clock::now();
+                double ns = std::chrono::duration<double, std::nano>(end - start).count() / probeCount;
+                if (batch == 1) scalarNs = ns;
+                bestNs = bestNs == 0.0 ? ns : std::min(bestNs, ns);
+                std::cout << std::setw(15) << ns;
+            }
+            std::cout << std::setw(14) << scalarNs / bestNs << "x\n";
+            if (sink == 0) std::cout << "(no matches)\n";
+        }
+    }
+
+void BenchmarkSuite::runHashFunctionBenchmark() {
+        std::cout << "\n=== Hash Function Throughput and Join Time ===\n";
+
+        const size_t intKeys = 1 << 20;
+        const size_t stringBytes = 16 << 20; // per string length
+        const std::vector<size_t> stringLengths = {16, 256};
+        const size_t joinBuildRows = 100000;
+        const size_t joinProbeRows = 2 * joinBuildRows;
+
+        srand(17);
+        std::vector<Value> ints;
+        ints.reserve(intKeys);
+        for (size_t i = 0; i < intKeys; ++i) {
+            ints.push_back(Value(static_cast<std::int64_t>(rand()) * 7919));
+        }
+        std::vector<std::vector<Value>> strings(stringLengths.size());
+        for (size_t l = 0; l < stringLengths.size(); ++l) {
+            for (size_t i = 0; i < stringBytes / stringLengths[l]; ++i) {
+                std::string s(stringLengths[l], ' ');
+                for (char& c : s) c = static_cast<char>('a' + rand() % 26);
+                strings[l].push_back(Value(s));
+            }
+        }
+
+        // unique keys on the build side, every probe key is present; integer
+        // keys are sparse enough that no join takes the direct array path
+        auto makeTable = [](const std::string& name, size_t rows, DataType type) {
+            auto table = std::make_unique<Table>(name);
+            table->addColumn("key", type);
+            for (size_t i = 0; i < rows; ++i) {
+                size_t key = (i % joinBuildRows) * 7919;
+                Row row;
+                if (type == DataType::STRING) {
+                    row.addValue(Value("Key_" + std::to_string(key)));
+                } else {
+                    row.addValue(Value(static_cast<std::int64_t>(key)));
+                }
+                table->addRow(row);
+            }
+            return table;
+        };
+        auto intBuild = makeTable("IntBuild", joinBuildRows, DataType::INTEGER);
+        auto intProbe = makeTable("IntProbe", joinProbeRows, DataType::INTEGER);
+        auto stringBuild = makeTable("StringBuild", joinBuildRows, DataType::STRING);
+        auto stringProbe = makeTable("StringProbe", joinProbeRows, DataType::STRING);
+
+        auto joinMs = [](const Table& build, const Table& probe, const std::string& hashFunction) {
+            JoinOptions options;
+            options.directAddressing = false;
+            options.hashFunction = hashFunction;
+            JoinEngine engine;
+            auto result = engine.hashJoin(build, "key", probe, "key", JoinType::INNER,
+                                          CollisionStrategy::CHAINING, options);
+            return engine.getProfiler().getData().totalTime.count() / 1e6;
+        };
+
+        std::cout << "Int keys: " << intKeys << ", string bytes per length: " << stringBytes
+                  << ", join: " << joinBuildRows << " x " << joinProbeRows << " rows (Chaining)\n";
+        std::cout << "CRC32C runs on " << (crc32cHardwareAvailable() ? "SSE4.2" : "the table fallback") << "\n";
+        std::cout << std::setw(20) << "Hash Function";
+        for (size_t length : stringLengths) {
+            std::cout << std::setw(15) << "Str" + std::to_string(length) + " GB/s";
+        }
+        std::cout << std::setw(15) << "Int keys/ns"
+                  << std::setw(15) << "Int Join ms"
+                  << std::setw(15) << "Str Join ms" << "\n";
+        std::cout << std::string(20 + 15 * (stringLengths.size() + 3), '-') << "\n";
+
+        // untimed, so the first row does not pay for warming the allocator
+        joinMs(*intBuild, *intProbe, "");
+
+        // the default join path (TypedValueHasher, no virtual call) first
+        std::vector<std::string> names = {""};
+        for (const auto& name : HashFunctionFactory<Value>::names()) names.push_back(name);
+
+        std::string bestIntJoin, bestStringJoin;
+        double bestIntMs = 0.0, bestStringMs = 0.0;
+        for (const auto& name : names) {
+            auto hasher = HashFunctionFactory<Value>::create(name.empty() ? "typed" : name);
+            std::string label = name.empty() ? "default (typed)" : hasher->getName();
+            std::cout << std::setw(20) << label << std::fixed << std::setprecision(2);
+
+            size_t sink = 0;
+            for (const auto& keys : strings) {
+                auto start = std::chrono::steady_clock::now();
+                for (const auto& key : keys) sink += (*hasher)(key);
+                auto end = std::chrono::steady_clock::now();
+                double bytes = static_cast<double>(keys.size()) * std::get<std::string>(keys[0].data).size();
+                std::cout << std::setw(15) << bytes / std::chrono::duration<double, std::nano>(end - start).count();
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            for (const auto& key : ints) sink += (*hasher)(key);
+            auto end = std::chrono::steady_clock::now();
+            std::cout << std::setw(15) << intKeys / std::chrono::duration<double, std::nano>(end - start).count();
+
+            double intMs = joinMs(*intBuild, *intProbe, name);
+            double stringMs = joinMs(*stringBuild, *stringProbe, name);
+            std::cout << std::setw(15) << intMs << std::setw(15) << stringMs << "\n";
+            if (sink == 1) std::cout << "(degenerate hash)\n";
+
+            if (bestIntJoin.empty() || intMs < bestIntMs) {
+                bestIntJoin = label;
+                bestIntMs = intMs;
+            }
+            if (bestStringJoin.empty() || stringMs < bestStringMs) {
+                bestStringJoin = label;
+                bestStringMs = stringMs;
+            }
+        }
+        std::cout << "Fastest integer join: " << bestIntJoin << ", fastest string join: " << bestStringJoin << "\n";
+    }
+
+void BenchmarkSuite::runRadixJoinBenchmark() {
+        std::cout << "\n=== Radix-Partitioned vs No-Partitioning Hash Join ===\n";
+
+        // equal-sized inputs of unique, sparse, shuffled keys, every probe
+        // key matching; the build side grows from inside L2 to far past it
+        const std::vector<size_t> sizes = {1 << 12, 1 << 14, 1 << 16, 1 << 18, 1 << 20, 1 << 22};
+        const size_t runs = 3;
+
+        auto makeTable = [](const std::string& name, size_t rows, unsigned seed) {
+            std::vector<std::int64_t> keys(rows);
+            for (size_t i = 0; i < rows; ++i) keys[i] = static_cast<std::int64_t>(i) * 7919;
+            std::shuffle(keys.begin(), keys.end(), std::mt19937(seed));
+            Column column(DataType::INTEGER);
+            column.reserve(rows);
+            for (std::int64_t key : keys) column.append(Value(key));
+            auto table = std::make_unique<Table>(name);
+            table->addColumn("key", std::move(column));
+            return table;
+        };
+
+        // best of runs, row id output so materialization does not hide the join
+        auto joinMs = [&](const Table& build, const Table& probe, JoinAlgorithm algorithm, int radixBits) {
+            JoinOptions options;
+            options.directAddressing = false;
+            options.algorithm = algorithm;
+            options.radixBits = radixBits;
+            double best = 0.0;
+            for (size_t run = 0; run < runs; ++run) {
+                JoinEngine engine;
+                auto result = engine.hashJoinRowIds(build, "key", probe, "key", JoinType::INNER,
+                                                    CollisionStrategy::CHAINING, options);
+                double ms = engine.getProfiler().getData().totalTime.count() / 1e6;
+                best = run == 0 ? ms : std::min(best, ms);
+            }
+            return best;
+        };
+
+        // "1 Partition" runs the radix path with 0 bits: the same tuples and
+        // bucket table without partitioning, which separates the gain of the
+        // compact layout from the gain of partitioning
+        std::cout << "No-partitioning uses Chaining; radix partitions target "
+                  << RadixPartitions::CACHE_BYTES / 1024 << " KB of build side each\n";
+        std::cout << std::setw(12) << "Build Rows"
+                  << std::setw(15) << "No-Part ms"
+                  << std::setw(15) << "1 Partition ms"
+                  << std::setw(15) << "Radix ms"
+                  << std::setw(12) << "Radix Bits"
+                  << std::setw(12) << "Speedup" << "\n";
+        std::cout << std::string(81, '-') << "\n";
+
+        // smallest sizes from which radix stays ahead
+        size_t crossover = 0;
+        size_t partitionCrossover = 0;
+        for (size_t rows : sizes) {
+            auto build = makeTable("Build", rows, 1);
+            auto probe = makeTable("Probe", rows, 2);
+            double plainMs = joinMs(*build, *probe, JoinAlgorithm::NO_PARTITIONING, -1);
+            double singleMs = joinMs(*build, *probe, JoinAlgorithm::RADIX, 0);
+            double radixMs = joinMs(*build, *probe, JoinAlgorithm::RADIX, -1);
+            unsigned bits = RadixPartitions::bitsFor(rows);
+            if (radixMs < plainMs) {
+                if (crossover == 0) crossover = rows;
+            } else {
+                crossover = 0;
+            }
+            if (bits > 0 && radixMs < singleMs) {
+                if (partitionCrossover == 0) partitionCrossover = rows;
+            } else {
+                partitionCrossover = 0;
+            }
+
+            std::cout << std::setw(12) << rows << std::fixed << std::setprecision(2)
+                      << std::setw(15) << plainMs
+                      << std::setw(15) << singleMs
+                      << std::setw(15) << radixMs
+                      << std::setw(12) << bits
+                      << std::setw(11) << plainMs / radixMs << "x\n";
+        }
+        auto printCrossover = [](const std::string& what, size_t rows) {
+            if (rows > 0) {
+                std::cout << what << " from " << rows << " build rows up\n";
+            } else {
+                std::cout << what << ": no crossover up to the largest size\n";
+            }
+        };
+        printCrossover("Radix join beats no-partitioning", crossover);
+        printCrossover("Partitioning beats one partition", partitionCrossover);
+    }
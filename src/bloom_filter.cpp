@@ -0,0 +1,27 @@
+#include "BloomFilter.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+BloomFilter::BloomFilter(size_t expectedKeys, double bitsPerKey) {
+    double bits = std::max<double>(expectedKeys, 1) * std::max(bitsPerKey, 1.0);
+    blockCount_ = static_cast<size_t>(std::ceil(bits / (WORDS_PER_BLOCK * 32)));
+    words_.assign(blockCount_ * WORDS_PER_BLOCK, 0);
+}
+
+BloomFilter BloomFilter::forColumn(const Table& table, const std::string& column, double bitsPerKey) {
+    auto columnIdx = table.getColumnIndex(column);
+    if (!columnIdx) {
+        throw std::runtime_error("Filter column not found: " + column);
+    }
+
+    BloomFilter filter(table.rowCount(), bitsPerKey);
+    const Column& keys = table.getColumn(*columnIdx);
+    ColumnScanner scanner(keys);
+    Value key;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        scanner.load(i, key);
+        filter.add(key);
+    }
+    return filter;
+}
@@ -0,0 +1,403 @@
+#include "Column.h"
+#include <climits>
+#include <stdexcept>
+
+uint32_t StringDictionary::intern(std::string_view s) {
+    auto [it, inserted] = codes_.emplace(std::string(s), static_cast<uint32_t>(strings_.size()));
+    if (inserted) {
+        if (strings_.size() >= NO_CODE) {
+            codes_.erase(it);
+            throw std::runtime_error("String dictionary is full");
+        }
+        strings_.push_back(&it->first);
+    }
+    return it->second;
+}
+
+uint32_t StringDictionary::find(std::string_view s) const {
+    auto it = codes_.find(std::string(s));
+    return it == codes_.end() ? NO_CODE : it->second;
+}
+
+size_t StringDictionary::memoryUsage() const {
+    size_t total = sizeof(*this) + strings_.capacity() * sizeof(const std::string*);
+    total += codes_.bucket_count() * sizeof(void*);
+    for (const auto& [s, code] : codes_) {
+        total += sizeof(std::pair<const std::string, uint32_t>) + sizeof(void*) + s.capacity();
+    }
+    return total;
+}
+
+Column::Column(DataType type) : type_(type) {
+    if (type_ == DataType::STRING) offsets_.push_back(0);
+    syncPointers();
+}
+
+Column Column::borrow(DataType type, size_t size, size_t nullCount, const Arrays& arrays,
+                      std::shared_ptr<const void> backing,
+                      std::shared_ptr<StringDictionary> dictionary) {
+    Column column(type);
+    column.offsets_.clear();
+    column.size_ = size;
+    column.nullCount_ = nullCount;
+    column.dictionary_ = std::move(dictionary);
+    column.backing_ = std::move(backing);
+    column.validityData_ = arrays.validity;
+    switch (type) {
+        case DataType::INTEGER: column.intData_ = static_cast<const int64_t*>(arrays.values); break;
+        case DataType::DOUBLE: column.doubleData_ = static_cast<const double*>(arrays.values); break;
+        case DataType::STRING:
+            if (column.dictionary_) {
+                column.codeData_ = static_cast<const uint32_t*>(arrays.values);
+            } else {
+                column.offsetData_ = static_cast<const uint64_t*>(arrays.values);
+                column.byteData_ = arrays.bytes;
+            }
+            break;
+        default: break;
+    }
+    return column;
+}
+
+// the vectors are copied; a borrowed column's pointers stay on the shared
+// backing
+Column::Column(const Column& other)
+    : type_(other.type_), size_(other.size_), nullCount_(other.nullCount_),
+      validity_(other.validity_), ints_(other.ints_), doubles_(other.doubles_),
+      offsets_(other.offsets_), bytes_(other.bytes_), codes_(other.codes_),
+      dictionary_(other.dictionary_),
+      encoding_(other.encoding_), reference_(other.reference_), bitWidth_(other.bitWidth_),
+      packed_(other.packed_), runValues_(other.runValues_), runEnds_(other.runEnds_),
+      validityData_(other.validityData_), intData_(other.intData_), doubleData_(other.doubleData_),
+      offsetData_(other.offsetData_), byteData_(other.byteData_), codeData_(other.codeData_),
+      backing_(other.backing_) {
+    if (!backing_) syncPointers();
+}
+
+Column& Column::operator=(const Column& other) {
+    if (this != &other) {
+        Column copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+void Column::syncPointers() {
+    validityData_ = validity_.data();
+    intData_ = encoding_ == ColumnEncoding::PLAIN ? ints_.data() : nullptr;
+    doubleData_ = doubles_.data();
+    offsetData_ = offsets_.data();
+    byteData_ = bytes_.data();
+    codeData_ = codes_.data();
+}
+
+void Column::makeWritable() {
+    decompress();
+    if (!backing_) return;
+    validity_.assign(validityData_, validityData_ + (size_ + 63) / 64);
+    switch (type_) {
+        case DataType::INTEGER: ints_.assign(intData_, intData_ + size_); break;
+        case DataType::DOUBLE: doubles_.assign(doubleData_, doubleData_ + size_); break;
+        case DataType::STRING:
+            if (dictionary_) {
+                codes_.assign(codeData_, codeData_ + size_);
+            } else {
+                offsets_.assign(offsetData_, offsetData_ + size_ + 1);
+                bytes_.assign(byteData_, byteData_ + offsetData_[size_]);
+            }
+            break;
+        default: break;
+    }
+    backing_.reset();
+    syncPointers();
+}
+
+void Column::appendValidity(bool valid) {
+    if ((size_ & 63) == 0) validity_.push_back(0);
+    if (valid) {
+        validity_.back() |= 1ULL << (size_ & 63);
+    } else {
+        nullCount_++;
+    }
+    size_++;
+}
+
+void Column::appendNull() {
+    makeWritable();
+    switch (type_) {
+        case DataType::INTEGER: ints_.push_back(0); break;
+        case DataType::DOUBLE: doubles_.push_back(0.0); break;
+        case DataType::STRING:
+            if (dictionary_) {
+                codes_.push_back(StringDictionary::NO_CODE);
+            } else {
+                offsets_.push_back(bytes_.size());
+            }
+            break;
+        default: break;
+    }
+    appendValidity(false);
+    syncPointers();
+}
+
+void Column::append(const Value& value) {
+    if (value.isNull()) {
+        appendNull();
+        return;
+    }
+    if (value.getType() != type_) {
+        throw std::runtime_error("Value type doesn't match column type");
+    }
+    makeWritable();
+    switch (type_) {
+        case DataType::INTEGER:
+            ints_.push_back(std::get<std::int64_t>(value.data));
+            break;
+        case DataType::DOUBLE:
+            doubles_.push_back(std::get<double>(value.data));
+            break;
+        case DataType::STRING: {
+            const std::string& s = std::get<std::string>(value.data);
+            if (dictionary_) {
+                codes_.push_back(dictionary_->intern(s));
+            } else {
+                bytes_.insert(bytes_.end(), s.begin(), s.end());
+                offsets_.push_back(bytes_.size());
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    appendValidity(true);
+    syncPointers();
+}
+
+void Column::appendFrom(const Column& other, size_t i) {
+    if (other.type_ != type_) {
+        throw std::runtime_error("Column type mismatch");
+    }
+    if (!other.isValid(i)) {
+        appendNull();
+        return;
+    }
+    makeWritable();
+    switch (type_) {
+        case DataType::INTEGER: ints_.push_back(other.int64At(i)); break;
+        case DataType::DOUBLE: doubles_.push_back(other.doubleData_[i]); break;
+        case DataType::STRING:
+            if (dictionary_ && other.dictionary_ == dictionary_) {
+                codes_.push_back(other.codeData_[i]);
+            } else if (dictionary_) {
+                codes_.push_back(dictionary_->intern(other.stringAt(i)));
+            } else {
+                std::string_view s = other.stringAt(i);
+                bytes_.insert(bytes_.end(), s.begin(), s.end());
+                offsets_.push_back(bytes_.size());
+            }
+            break;
+        default: break;
+    }
+    appendValidity(true);
+    syncPointers();
+}
+
+void Column::reserve(size_t rows) {
+    makeWritable();
+    validity_.reserve((rows + 63) / 64);
+    switch (type_) {
+        case DataType::INTEGER: ints_.reserve(rows); break;
+        case DataType::DOUBLE: doubles_.reserve(rows); break;
+        case DataType::STRING:
+            if (dictionary_) {
+                codes_.reserve(rows);
+            } else {
+                offsets_.reserve(rows + 1);
+            }
+            break;
+        default: break;
+    }
+    syncPointers();
+}
+
+void Column::encodeDictionary(std::shared_ptr<StringDictionary> dictionary) {
+    if (type_ != DataType::STRING) {
+        throw std::runtime_error("Only STRING columns can be dictionary-encoded");
+    }
+    if (!dictionary) dictionary = std::make_shared<StringDictionary>();
+    if (dictionary_ == dictionary) return;
+    makeWritable();
+
+    Array<uint32_t> codes;
+    codes.reserve(size_);
+    for (size_t i = 0; i < size_; ++i) {
+        codes.push_back(isValid(i) ? dictionary->intern(stringAt(i)) : StringDictionary::NO_CODE);
+    }
+    codes_ = std::move(codes);
+    dictionary_ = std::move(dictionary);
+    Array<uint64_t>().swap(offsets_);
+    Array<char>().swap(bytes_);
+    syncPointers();
+}
+
+void Column::compress() {
+    if (type_ != DataType::INTEGER || size_ == 0) return;
+    makeWritable();
+
+    // NULL rows may hold any value: each takes the row before it (the first
+    // valid value at the start), which keeps runs unbroken and the range as
+    // narrow as the valid values
+    size_t first = 0;
+    while (first < size_ && !isValid(first)) ++first;
+    int64_t fill = first < size_ ? ints_[first] : 0;
+    int64_t minValue = fill, maxValue = fill;
+    size_t runs = 0;
+    for (size_t i = 0; i < size_; ++i) {
+        int64_t value = isValid(i) ? ints_[i] : fill;
+        if (i == 0 || value != fill) runs++;
+        fill = value;
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+    }
+
+    unsigned width = bitWidthFor(static_cast<uint64_t>(maxValue) - static_cast<uint64_t>(minValue));
+    size_t plainBytes = size_ * sizeof(int64_t);
+    size_t packedBytes = packedWords(size_, width) * sizeof(uint64_t);
+    size_t rleBytes = size_ < UINT32_MAX ? runs * (sizeof(int64_t) + sizeof(uint32_t)) : SIZE_MAX;
+    if (plainBytes <= std::min(packedBytes, rleBytes)) return;
+
+    fill = first < size_ ? ints_[first] : 0;
+    if (packedBytes <= rleBytes) {
+        packed_.assign(packedWords(size_, width), 0);
+        for (size_t i = 0; i < size_; ++i) {
+            int64_t value = isValid(i) ? ints_[i] : fill;
+            packValue(packed_.data(), i, width, static_cast<uint64_t>(value) - static_cast<uint64_t>(minValue));
+            fill = value;
+        }
+        encoding_ = ColumnEncoding::BITPACKED;
+        reference_ = minValue;
+        bitWidth_ = width;
+    } else {
+        runValues_.reserve(runs);
+        runEnds_.reserve(runs);
+        for (size_t i = 0; i < size_; ++i) {
+            int64_t value = isValid(i) ? ints_[i] : fill;
+            if (i == 0 || value != fill) {
+                runValues_.push_back(value);
+                runEnds_.push_back(0);
+            }
+            runEnds_.back() = static_cast<uint32_t>(i + 1);
+            fill = value;
+        }
+        encoding_ = ColumnEncoding::RLE;
+    }
+    Array<int64_t>().swap(ints_);
+    syncPointers();
+}
+
+void Column::decompress() {
+    if (encoding_ == ColumnEncoding::PLAIN) return;
+    Array<int64_t> values(size_);
+    decodeInt64(0, size_, values.data());
+    if (nullCount_ > 0) {
+        for (size_t i = 0; i < size_; ++i) {
+            if (!isValid(i)) values[i] = 0;
+        }
+    }
+    ints_ = std::move(values);
+    Array<uint64_t>().swap(packed_);
+    Array<int64_t>().swap(runValues_);
+    Array<uint32_t>().swap(runEnds_);
+    encoding_ = ColumnEncoding::PLAIN;
+    reference_ = 0;
+    bitWidth_ = 0;
+    syncPointers();
+}
+
+int64_t Column::encodedInt64At(size_t i) const {
+    if (encoding_ == ColumnEncoding::BITPACKED) {
+        return unpackValue(packed_.data(), i, bitWidth_, reference_);
+    }
+    size_t run = std::upper_bound(runEnds_.begin(), runEnds_.end(), i) - runEnds_.begin();
+    return runValues_[run];
+}
+
+void Column::decodeInt64(size_t begin, size_t end, int64_t* out) const {
+    switch (encoding_) {
+        case ColumnEncoding::PLAIN:
+            std::copy(intData_ + begin, intData_ + end, out);
+            break;
+        case ColumnEncoding::BITPACKED:
+            unpackRange(packed_.data(), bitWidth_, reference_, begin, end, out);
+            break;
+        case ColumnEncoding::RLE: {
+            size_t run = std::upper_bound(runEnds_.begin(), runEnds_.end(), begin) - runEnds_.begin();
+            for (size_t i = begin; i < end; ++run) {
+                size_t stop = std::min<size_t>(end, runEnds_[run]);
+                std::fill(out + (i - begin), out + (stop - begin), runValues_[run]);
+                i = stop;
+            }
+            break;
+        }
+    }
+}
+
+Value Column::valueAt(size_t i) const {
+    if (!isValid(i)) return Value();
+    switch (type_) {
+        case DataType::INTEGER: return Value(int64At(i));
+        case DataType::DOUBLE: return Value(doubleData_[i]);
+        case DataType::STRING: return Value(std::string(stringAt(i)));
+        default: return Value();
+    }
+}
+
+void Column::loadValue(size_t i, Value& out) const {
+    if (!isValid(i)) {
+        out.data = std::monostate{};
+        return;
+    }
+    switch (type_) {
+        case DataType::INTEGER: out.data = int64At(i); break;
+        case DataType::DOUBLE: out.data = doubleData_[i]; break;
+        case DataType::STRING:
+            if (auto* s = std::get_if<std::string>(&out.data)) {
+                s->assign(stringAt(i));
+            } else {
+                out.data = std::string(stringAt(i));
+            }
+            break;
+        default: out.data = std::monostate{}; break;
+    }
+}
+
+// a shared dictionary is counted by every column that uses it; borrowed
+// arrays belong to their backing and are not counted
+size_t Column::memoryUsage() const {
+    return sizeof(*this) + validity_.capacity() * sizeof(uint64_t) +
+           ints_.capacity() * sizeof(int64_t) + doubles_.capacity() * sizeof(double) +
+           offsets_.capacity() * sizeof(uint64_t) + bytes_.capacity() +
+           codes_.capacity() * sizeof(uint32_t) + packed_.capacity() * sizeof(uint64_t) +
+           runValues_.capacity() * sizeof(int64_t) + runEnds_.capacity() * sizeof(uint32_t) +
+           (dictionary_ ? dictionary_->memoryUsage() : 0);
+}
+
+void Column::clear() {
+    backing_.reset();
+    size_ = 0;
+    nullCount_ = 0;
+    validity_.clear();
+    ints_.clear();
+    doubles_.clear();
+    offsets_.clear();
+    bytes_.clear();
+    codes_.clear();
+    packed_.clear();
+    runValues_.clear();
+    runEnds_.clear();
+    encoding_ = ColumnEncoding::PLAIN;
+    reference_ = 0;
+    bitWidth_ = 0;
+    if (type_ == DataType::STRING && !dictionary_) offsets_.push_back(0);
+    syncPointers();
+}
@@ -0,0 +1,142 @@
+#include "CRC32C.h"
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define BIFROST_CRC32C_X86 1
+#endif
+
+namespace {
+
+constexpr uint32_t POLY = 0x82F63B78U; // reflected Castagnoli
+constexpr uint32_t LANE_SALT = 0x9E3779B9U;
+
+constexpr std::array<uint32_t, 256> makeTable() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (POLY & (0U - (crc & 1U)));
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr std::array<uint32_t, 256> TABLE = makeTable();
+
+inline uint64_t read64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// single steps without the pre/post inversion
+inline uint32_t softwareStep8(uint32_t crc, uint8_t byte) {
+    return (crc >> 8) ^ TABLE[(crc ^ byte) & 0xFF];
+}
+
+inline uint32_t softwareStep64(uint32_t crc, uint64_t word) {
+    for (int i = 0; i < 8; ++i) {
+        crc = softwareStep8(crc, static_cast<uint8_t>(word >> (8 * i)));
+    }
+    return crc;
+}
+
+uint32_t softwareCrc(uint32_t crc, const uint8_t* p, size_t length) {
+    for (size_t i = 0; i < length; ++i) crc = softwareStep8(crc, p[i]);
+    return crc;
+}
+
+uint64_t softwareLanes(uint32_t a, uint32_t b, const uint8_t* p, size_t length) {
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        a = softwareStep64(a, read64(p + i));
+        b = softwareStep64(b, read64(p + i + 8));
+    }
+    if (i + 8 <= length) {
+        a = softwareStep64(a, read64(p + i));
+        i += 8;
+    }
+    a = softwareCrc(a, p + i, length - i);
+    return (static_cast<uint64_t>(a) << 32) | b;
+}
+
+#ifdef BIFROST_CRC32C_X86
+__attribute__((target("sse4.2")))
+uint32_t hardwareCrc(uint32_t crc, const uint8_t* p, size_t length) {
+    uint64_t wide = crc;
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) wide = _mm_crc32_u64(wide, read64(p + i));
+    crc = static_cast<uint32_t>(wide);
+    for (; i < length; ++i) crc = _mm_crc32_u8(crc, p[i]);
+    return crc;
+}
+
+__attribute__((target("sse4.2")))
+uint64_t hardwareLanes(uint32_t a, uint32_t b, const uint8_t* p, size_t length) {
+    uint64_t wideA = a, wideB = b;
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        wideA = _mm_crc32_u64(wideA, read64(p + i));
+        wideB = _mm_crc32_u64(wideB, read64(p + i + 8));
+    }
+    if (i + 8 <= length) {
+        wideA = _mm_crc32_u64(wideA, read64(p + i));
+        i += 8;
+    }
+    a = static_cast<uint32_t>(wideA);
+    for (; i < length; ++i) a = _mm_crc32_u8(a, p[i]);
+    return (static_cast<uint64_t>(a) << 32) | static_cast<uint32_t>(wideB);
+}
+#endif
+
+const bool HARDWARE = [] {
+#if defined(__SSE4_2__)
+    return true;
+#elif defined(BIFROST_CRC32C_X86)
+    return __builtin_cpu_supports("sse4.2") != 0;
+#else
+    return false;
+#endif
+}();
+
+} // namespace
+
+bool crc32cHardwareAvailable() {
+    return HARDWARE;
+}
+
+uint32_t crc32c(const void* data, size_t length, uint32_t crc) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+#ifdef BIFROST_CRC32C_X86
+    if (HARDWARE) return ~hardwareCrc(~crc, p, length);
+#endif
+    return ~softwareCrc(~crc, p, length);
+}
+
+uint64_t crc32cHash64(const void* data, size_t length, uint64_t seed) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    uint32_t a = static_cast<uint32_t>(seed);
+    uint32_t b = static_cast<uint32_t>(seed >> 32) ^ LANE_SALT;
+    uint64_t lanes;
+#ifdef BIFROST_CRC32C_X86
+    if (HARDWARE) {
+        lanes = hardwareLanes(a, b, p, length);
+    } else {
+        lanes = softwareLanes(a, b, p, length);
+    }
+#else
+    lanes = softwareLanes(a, b, p, length);
+#endif
+    // CRC is linear in its input, so finish with a nonlinear mix that also
+    // spreads both lanes over all 64 bits; bucket indexes use the low ones
+    uint64_t h = lanes ^ length;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
@@ -1,4 +1,5 @@
 #include "DataLoader.h"
+#include "BloomFilter.h"
 #include <iostream>
 #include <sstream>
 #include <map>
@@ -63,6 +64,16 @@ Value DataLoader::parseValue(const std::string& str, DataType type) {
 }
 
 std::unique_ptr<Table> DataLoader::loadFromCSV(const std::string& filename, const std::string& tablename) {
+    return loadCSV(filename, tablename, nullptr, nullptr);
+}
+
+std::unique_ptr<Table> DataLoader::loadFromCSV(const std::string& filename, const std::string& tablename,
+                                               const std::string& filterColumn, const BloomFilter& filter) {
+    return loadCSV(filename, tablename, &filterColumn, &filter);
+}
+
+std::unique_ptr<Table> DataLoader::loadCSV(const std::string& filename, const std::string& tablename,
+                                           const std::string* filterColumn, const BloomFilter* filter) {
     std::ifstream file(filename);
     if (!file.is_open()) {
         throw std::runtime_error("Cannot open file: "+ filename);
@@ -113,6 +124,15 @@ std::unique_ptr<Table> DataLoader::loadFromCSV(const std::string& filename, cons
         table->addColumn(headers[i], columnTypes[i]);
     }
 
+    size_t filterIdx = 0;
+    if (filter) {
+        auto idx = table->getColumnIndex(*filterColumn);
+        if (!idx) {
+            throw std::runtime_error("Filter column not found: " + *filterColumn);
+        }
+        filterIdx = *idx;
+    }
+
     file.clear();
     file.seekg(0);
     std::getline(file, line); // start from the first row, first value
@@ -120,6 +140,13 @@ std::unique_ptr<Table> DataLoader::loadFromCSV(const std::string& filename, cons
     // reading starts
     while (std::getline(file, line)) {
         auto values = split(line, ',');
+
+        // check the filter on the one parsed value before building the row
+        if (filter) {
+            Value key = filterIdx < values.size() ? parseValue(values[filterIdx], columnTypes[filterIdx]) : Value();
+            if (!filter->mayContain(key)) continue;
+        }
+
         Row row;
 
         for(size_t i=0; i<headers.size() && i<values.size(); ++i){
@@ -133,9 +160,28 @@ std::unique_ptr<Table> DataLoader::loadFromCSV(const std::string& filename, cons
         table->addRow(row);
     }
 
+    encodeStringColumns(*table);
+    table->compressColumns();
     return table;
 }
 
+void DataLoader::encodeStringColumns(Table& table) {
+    for (size_t col = 0; col < table.columnCount(); ++col) {
+        const Column& column = table.getColumn(col);
+        if (column.type() != DataType::STRING || column.isDictionaryEncoded()) continue;
+
+        // the trial dictionary becomes the real one; give up once it is too big
+        size_t maxDistinct = column.size() / MIN_ROWS_PER_STRING;
+        auto dictionary = std::make_shared<StringDictionary>();
+        for (size_t i = 0; i < column.size() && dictionary->size() <= maxDistinct; ++i) {
+            if (column.isValid(i)) dictionary->intern(column.stringAt(i));
+        }
+        if (dictionary->size() <= maxDistinct) {
+            table.encodeColumn(col, std::move(dictionary));
+        }
+    }
+}
+
 
 std::unique_ptr<Table> DataLoader::generateTestTable(const std::string& name, size_t rows, int seed = 42) {
         srand(seed);
@@ -145,6 +191,7 @@ std::unique_ptr<Table> DataLoader::generateTestTable(const std::string& name, si
         table->addColumn("value", DataType::INTEGER);
         table->addColumn("name", DataType::STRING);
         table->addColumn("score", DataType::DOUBLE);
+        table->reserve(rows);
         
         for (size_t i = 0; i < rows; ++i) {
             Row row;
@@ -154,6 +201,10 @@ std::unique_ptr<Table> DataLoader::generateTestTable(const std::string& name, si
             row.addValue(Value(static_cast<double>(rand()) / RAND_MAX * 100.0));
             table->addRow(row);
         }
+        // "name" has 50 distinct values
+        encodeStringColumns(*table);
+        // "value" packs into 7 bits
+        table->compressColumns();
         
         return table;
     }
\ No newline at end of file
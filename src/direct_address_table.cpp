@@ -0,0 +1,106 @@
+#include "DirectAddressTable.h"
+#include <algorithm>
+#include <limits>
+
+std::unique_ptr<DirectAddressTable> DirectAddressTable::tryBuild(const Table& table, size_t columnIdx,
+                                                                 std::string& rejectReason) {
+    if (table.getSchema()[columnIdx].type != DataType::INTEGER) {
+        rejectReason = "join column is not INTEGER";
+        return nullptr;
+    }
+
+    const Column& column = table.getColumn(columnIdx);
+    if (column.nullCount() > 0) {
+        rejectReason = "join column has NULL keys";
+        return nullptr;
+    }
+    if (!column.int64Data()) {
+        // compressed keys are unpacked once for the two passes
+        TrackedVector<int64_t, MemoryComponent::HASH_TABLE> keys(column.size());
+        column.decodeInt64(0, column.size(), keys.data());
+        return tryBuild(keys.data(), table.rowCount(), rejectReason);
+    }
+    return tryBuild(column.int64Data(), table.rowCount(), rejectReason);
+}
+
+template<typename Key>
+std::unique_ptr<DirectAddressTable> DirectAddressTable::tryBuild(const Key* keys, size_t rows,
+                                                                 std::string& rejectReason) {
+    if (rows == 0 || rows >= UINT32_MAX) {
+        rejectReason = "build row count out of range";
+        return nullptr;
+    }
+
+    // pass 1: key range
+    int64_t minKey = std::numeric_limits<int64_t>::max();
+    int64_t maxKey = std::numeric_limits<int64_t>::min();
+    for (size_t i = 0; i < rows; ++i) {
+        minKey = std::min<int64_t>(minKey, keys[i]);
+        maxKey = std::max<int64_t>(maxKey, keys[i]);
+    }
+
+    uint64_t span = static_cast<uint64_t>(maxKey) - static_cast<uint64_t>(minKey) + 1;
+    uint64_t limit = std::max<uint64_t>(MIN_SPAN_LIMIT, MAX_SPAN_PER_ROW * rows);
+    if (span == 0 || span > limit || span >= UINT32_MAX) {
+        rejectReason = "key range [" + std::to_string(minKey) + ", " + std::to_string(maxKey) +
+                       "] is too sparse for " + std::to_string(rows) + " rows";
+        return nullptr;
+    }
+
+    std::unique_ptr<DirectAddressTable> index(new DirectAddressTable());
+    index->minKey_ = minKey;
+    index->span_ = static_cast<size_t>(span);
+    index->presence_.assign((index->span_ + 63) / 64, 0);
+    index->offsets_.assign(index->span_ + 1, 0);
+
+    // pass 2: rows per key (in offsets_[slot + 1]), then start offsets
+    for (size_t i = 0; i < rows; ++i) {
+        size_t slot = index->slotOf(keys[i]);
+        if (index->offsets_[slot + 1]++ == 0) {
+            index->presence_[slot >> 6] |= 1ULL << (slot & 63);
+            index->distinctKeys_++;
+        }
+    }
+    for (size_t slot = 1; slot <= index->span_; ++slot) {
+        index->offsets_[slot] += index->offsets_[slot - 1];
+    }
+
+    // pass 3: scatter row ids, keeping build order within a key
+    index->rowIds_.resize(rows);
+    TrackedVector<uint32_t, MemoryComponent::HASH_TABLE> cursor(index->offsets_.begin(), index->offsets_.end() - 1);
+    for (size_t i = 0; i < rows; ++i) {
+        size_t slot = index->slotOf(keys[i]);
+        index->rowIds_[cursor[slot]++] = static_cast<uint32_t>(i);
+    }
+    return index;
+}
+
+template std::unique_ptr<DirectAddressTable> DirectAddressTable::tryBuild(const int64_t*, size_t, std::string&);
+template std::unique_ptr<DirectAddressTable> DirectAddressTable::tryBuild(const uint32_t*, size_t, std::string&);
+
+HashTableStats DirectAddressTable::getStats() const {
+    HashTableStats stats;
+    stats.totalBuckets = span_;
+    stats.usedBuckets = distinctKeys_;
+    stats.totalEntries = rowIds_.size();
+    stats.loadFactor = span_ > 0 ? static_cast<double>(distinctKeys_) / span_ : 0.0;
+    stats.avgChainLength = distinctKeys_ > 0 ? static_cast<double>(rowIds_.size()) / distinctKeys_ : 0.0;
+    for (size_t slot = 0; slot < span_; ++slot) {
+        stats.maxChainLength = std::max<size_t>(stats.maxChainLength, offsets_[slot + 1] - offsets_[slot]);
+    }
+    stats.memoryUsage = sizeof(*this) + presence_.capacity() * sizeof(uint64_t) +
+                        (offsets_.capacity() + rowIds_.capacity()) * sizeof(uint32_t);
+    return stats;
+}
+
+DetailedHashTableStats DirectAddressTable::computeDetailedStats() const {
+    DetailedHashTableStats detailed;
+    detailed.summary = getStats();
+    // every lookup lands on its slot directly, so all distances are 0
+    detailed.chainLengthHistogram.assign(detailed.summary.maxChainLength + 1, 0);
+    for (size_t slot = 0; slot < span_; ++slot) {
+        detailed.chainLengthHistogram[offsets_[slot + 1] - offsets_[slot]]++;
+    }
+    detailed.probeDistanceHistogram.assign(1, distinctKeys_);
+    return detailed;
+}
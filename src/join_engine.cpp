@@ -1,6 +1,17 @@
 #include <algorithm>
+#include <filesystem>
 #include "JoinEngine.h"
 #include "HashFunction.h"
+#include "ConcurrentHashTable.h"
+#include "BloomFilter.h"
+#include "CsrHashTable.h"
+#include "DirectAddressTable.h"
+#include "RadixPartition.h"
+#include "SpillFile.h"
+
+// join bookkeeping is counted under MemoryComponent::JOIN
+template <typename T>
+using JoinArray = TrackedVector<T, MemoryComponent::JOIN>;
 
 // struct ValueHasher {
 //     std::size_t operator()(const Value& v) const {
@@ -22,6 +33,10 @@
 
 std::pair<const Table *, const Table *> JoinEngine::chooseBuildProbe(const Table &left, const Table &right)
 {
+    if (buildLeft_)
+    {
+        return *buildLeft_ ? std::make_pair(&left, &right) : std::make_pair(&right, &left);
+    }
     if (left.rowCount() <= right.rowCount())
     {
         return {&left, &right};
@@ -32,37 +47,154 @@ std::pair<const Table *, const Table *> JoinEngine::chooseBuildProbe(const Table
     }
 }
 
-Row JoinEngine::combineRows(const Row &left, const Row &right)
+// what the build paths below would hold for these build keys: a fixed cost
+// per row plus the bytes of string keys (codes are fixed-size)
+static size_t estimateBuildBytes(const Column &buildKeys, bool joinOnCodes, size_t bytesPerRow)
+{
+    size_t bytes = buildKeys.size() * bytesPerRow;
+    if (!joinOnCodes && buildKeys.type() == DataType::STRING)
+    {
+        for (size_t i = 0; i < buildKeys.size(); ++i)
+        {
+            if (buildKeys.isValid(i)) bytes += buildKeys.stringAt(i).size();
+        }
+    }
+    return bytes;
+}
+
+template <typename LoadBuildKey, typename LoadProbeKey>
+JoinResult JoinEngine::graceJoin(
+    const Table &leftTable,
+    const Table &rightTable,
+    bool leftIsBuild,
+    DataType buildKeyType,
+    DataType probeKeyType,
+    size_t buildBytes,
+    LoadBuildKey &&loadBuildKey,
+    LoadProbeKey &&loadProbeKey,
+    JoinType joinType,
+    CollisionStrategy strategy,
+    const JoinOptions &options)
 {
-    std::vector<Value> combined;
-    combined.reserve(left.size() + right.size());
+    const Table &buildTable = leftIsBuild ? leftTable : rightTable;
+    const Table &probeTable = leftIsBuild ? rightTable : leftTable;
 
-    for (const auto &value : left.getValues())
+    // twice the partitions an even spread would need, so that most still
+    // fit when keys spread unevenly
+    size_t budget = std::max(options.memoryBudget, SPILL_MIN_BUILD_BYTES);
+    size_t fanout = std::clamp<size_t>(2 * buildBytes / budget + 1, 2, MAX_SPILL_FANOUT);
+    std::string directory = options.spillDirectory.empty()
+        ? std::filesystem::temp_directory_path().string() : options.spillDirectory;
+
+    // PARTITION PHASE: only (row id, key) goes to disk. Equal keys hash
+    // alike on both sides, so each pair of partitions joins on its own; the
+    // seed changes per level so a re-partitioned pair splits again. Files
+    // are created on their first row.
+    std::vector<std::unique_ptr<SpillFile>> buildParts(fanout);
+    std::vector<std::unique_ptr<SpillFile>> probeParts(fanout);
+    TypedValueHasher partitionHasher(buildKeyType, SPILL_SEED + spillDepth_);
+    auto spill = [&](std::vector<std::unique_ptr<SpillFile>> &parts, DataType keyType, size_t i, const Value &key)
+    {
+        std::unique_ptr<SpillFile> &part = parts[partitionHasher(key) % fanout];
+        if (!part) part = std::make_unique<SpillFile>(directory, keyType);
+        part->append(static_cast<uint32_t>(i), key);
+    };
+    Value key;
+    for (size_t i = 0; i < buildTable.rowCount(); ++i)
+    {
+        loadBuildKey(i, key);
+        spill(buildParts, buildKeyType, i, key);
+    }
+    for (size_t i = 0; i < probeTable.rowCount(); ++i)
     {
-        combined.push_back(value);
+        loadProbeKey(i, key);
+        spill(probeParts, probeKeyType, i, key);
     }
 
-    for (const auto &value : right.getValues())
+    size_t spilledBytes = 0;
+    for (size_t p = 0; p < fanout; ++p)
     {
-        combined.push_back(value);
+        if (buildParts[p]) spilledBytes += buildParts[p]->bytesWritten();
+        if (probeParts[p]) spilledBytes += probeParts[p]->bytesWritten();
     }
+    profiler_.markBuildComplete();
+    profiler_.recordSpill(fanout, spilledBytes, spillDepth_ + 1);
+    profiler_.recordJoinPath("grace hash join (" + std::to_string(fanout) + " partitions, level " +
+                             std::to_string(spillDepth_ + 1) + ")");
 
-    return Row(std::move(combined));
-}
+    // JOIN PHASE: one pair in memory at a time, through a nested engine that
+    // spills again if the pair is still over budget
+    JoinResult result(leftTable, rightTable);
+    for (size_t p = 0; p < fanout; ++p)
+    {
+        size_t buildRows = buildParts[p] ? buildParts[p]->rowCount() : 0;
+        size_t probeRows = probeParts[p] ? probeParts[p]->rowCount() : 0;
+        if (buildRows == 0 && probeRows == 0) continue;
+        if (joinType == JoinType::INNER && (buildRows == 0 || probeRows == 0)) continue;
 
-Row JoinEngine::createNullRow(size_t columnCount)
-{
-    std::vector<Value> nullValues(columnCount);
-    return Row(std::move(nullValues));
+        // an empty side is an empty table with the same columns
+        auto readPart = [](std::unique_ptr<SpillFile> &part, DataType keyType, const char *name)
+        {
+            std::unique_ptr<Table> table;
+            if (part)
+            {
+                table = part->readTable(name);
+                part.reset();
+            }
+            else
+            {
+                table = std::make_unique<Table>(name);
+                table->addColumn("key", keyType);
+                table->addColumn("row", DataType::INTEGER);
+            }
+            return table;
+        };
+        std::unique_ptr<Table> buildPart = readPart(buildParts[p], buildKeyType, "build_partition");
+        std::unique_ptr<Table> probePart = readPart(probeParts[p], probeKeyType, "probe_partition");
+        const Table &leftPart = leftIsBuild ? *buildPart : *probePart;
+        const Table &rightPart = leftIsBuild ? *probePart : *buildPart;
+
+        JoinEngine partitionEngine;
+        partitionEngine.buildLeft_ = leftIsBuild;
+        partitionEngine.profiler_.setNested(true);
+        // all rows in one partition means one key; splitting again won't help
+        partitionEngine.spillDepth_ = buildRows == buildTable.rowCount() ? MAX_SPILL_DEPTH : spillDepth_ + 1;
+        JoinResult pairs = partitionEngine.hashJoinRowIds(leftPart, "key", rightPart, "key",
+                                                          joinType, strategy, options);
+
+        // partition rows back to input rows
+        const Column &leftRows = leftPart.getColumn(1);
+        const Column &rightRows = rightPart.getColumn(1);
+        for (const RowIdPair &pair : pairs.getRowIds())
+        {
+            result.add(pair.left == JoinResult::NULL_ROW ? JoinResult::NULL_ROW : leftRows.int64At(pair.left),
+                       pair.right == JoinResult::NULL_ROW ? JoinResult::NULL_ROW : rightRows.int64At(pair.right));
+        }
+
+        // the report shows the largest partition's lookup structure
+        const Profiler::ProfileData &nested = partitionEngine.getProfiler().getData();
+        if (nested.hashStats.memoryUsage >= profiler_.getData().hashStats.memoryUsage)
+        {
+            profiler_.recordHashStats(nested.hashStats);
+        }
+        if (nested.spillPartitions > 0)
+        {
+            profiler_.recordSpill(nested.spillPartitions, nested.spillBytes, nested.spillDepth);
+        }
+    }
+
+    profiler_.markProbeComplete();
+    return result;
 }
 
-std::unique_ptr<Table> JoinEngine::hashJoin(
+JoinResult JoinEngine::joinRowIds(
     const Table &leftTable,
     const std::string &leftColumn,
     const Table &rightTable,
     const std::string &rightColumn,
     JoinType joinType,
-    CollisionStrategy strategy)
+    CollisionStrategy strategy,
+    const JoinOptions &options)
 {
     profiler_.startProfiling();
 
@@ -80,67 +212,499 @@ std::unique_ptr<Table> JoinEngine::hashJoin(
     size_t buildColIdx = leftIsBuild ? *leftColIdx : *rightColIdx;
     size_t probeColIdx = leftIsBuild ? *rightColIdx : *leftColIdx;
 
-    // Create result with combined schema
-    auto result = std::make_unique<Table>("JoinResult");
+    // row ids are stored as 32 bits, with UINT32_MAX meaning "no row"
+    if (leftTable.rowCount() >= JoinResult::NULL_ROW || rightTable.rowCount() >= JoinResult::NULL_ROW)
+    {
+        throw std::runtime_error("Join supports fewer than 2^32 rows per table");
+    }
+
+    JoinResult result(leftTable, rightTable);
+
+    // join keys are read straight from the key columns
+    const Column &buildKeys = buildTable->getColumn(buildColIdx);
+    const Column &probeKeys = probeTable->getColumn(probeColIdx);
 
-    // Add columns from left table
-    for (const auto &col : leftTable.getSchema())
+    // both key columns dictionary-encoded: join on the 32-bit codes as
+    // INTEGER keys. Probe codes are translated into the build dictionary
+    // unless both sides share one; a string the build side lacks gets a key
+    // no build row has. NULL build keys would need a code of their own, so
+    // they keep the string path.
+    bool joinOnCodes = options.dictionaryCodes && buildKeys.isDictionaryEncoded() &&
+                       probeKeys.isDictionaryEncoded() && buildKeys.nullCount() == 0;
+    bool remapCodes = joinOnCodes && probeKeys.dictionary() != buildKeys.dictionary();
+    JoinArray<uint32_t> probeCodeMap;
+    if (remapCodes)
     {
-        result->addColumn("L_" + col.name, col.type);
+        const StringDictionary &probeDictionary = *probeKeys.dictionary();
+        probeCodeMap.resize(probeDictionary.size());
+        for (uint32_t code = 0; code < probeCodeMap.size(); ++code)
+        {
+            probeCodeMap[code] = buildKeys.dictionary()->find(probeDictionary.at(code));
+        }
     }
 
-    // Add columns from right table
-    for (const auto &col : rightTable.getSchema())
+    // key of row i as the lookup structures see it. The build and probe
+    // scans run in row order, so compressed keys are unpacked a block at a
+    // time; the concurrent build reads rows from several threads and uses
+    // loadBuildKeyAt instead.
+    ColumnScanner buildScanner(buildKeys);
+    ColumnScanner probeScanner(probeKeys);
+    auto loadBuildKeyAt = [&](size_t i, Value &key)
+    {
+        if (joinOnCodes)
+        {
+            key.data = static_cast<std::int64_t>(buildKeys.codeAt(i));
+        }
+        else
+        {
+            buildKeys.loadValue(i, key);
+        }
+    };
+    auto loadBuildKey = [&](size_t i, Value &key)
     {
-        result->addColumn("R_" + col.name, col.type);
+        if (joinOnCodes)
+        {
+            key.data = static_cast<std::int64_t>(buildKeys.codeAt(i));
+        }
+        else
+        {
+            buildScanner.load(i, key);
+        }
+    };
+    auto probeCodeKey = [&](size_t i)
+    {
+        uint32_t code = probeKeys.codeAt(i);
+        if (remapCodes && code != StringDictionary::NO_CODE) code = probeCodeMap[code];
+        return code == StringDictionary::NO_CODE ? std::int64_t(-1) : static_cast<std::int64_t>(code);
+    };
+    auto loadProbeKey = [&](size_t i, Value &key)
+    {
+        if (joinOnCodes)
+        {
+            key.data = probeCodeKey(i);
+        }
+        else
+        {
+            probeScanner.load(i, key);
+        }
+    };
+    auto loadProbeKeyAt = [&](size_t i, Value &key)
+    {
+        if (joinOnCodes)
+        {
+            key.data = probeCodeKey(i);
+        }
+        else
+        {
+            probeKeys.loadValue(i, key);
+        }
+    };
+
+    // INTEGER keys on both sides, dictionary codes included, are looked up
+    // as plain int64_t: read from the columns' arrays and hashed by the
+    // int64 kernel, with no Value per row. A NULL build key matches NULL
+    // probe keys, which needs Value, so such a build side keeps the Value
+    // path.
+    bool int64Keys = joinOnCodes || (buildKeys.type() == DataType::INTEGER &&
+                                      probeKeys.type() == DataType::INTEGER && buildKeys.nullCount() == 0);
+    auto loadBuildInt64 = [&](size_t i, std::int64_t &key)
+    {
+        key = joinOnCodes ? static_cast<std::int64_t>(buildKeys.codeAt(i)) : buildScanner.int64At(i);
+    };
+    auto loadBuildInt64At = [&](size_t i, std::int64_t &key)
+    {
+        key = joinOnCodes ? static_cast<std::int64_t>(buildKeys.codeAt(i)) : buildKeys.int64At(i);
+    };
+    // false for a NULL probe key, which no build key matches
+    auto loadProbeInt64 = [&](size_t i, std::int64_t &key)
+    {
+        if (joinOnCodes)
+        {
+            key = probeCodeKey(i);
+            return true;
+        }
+        if (probeKeys.nullCount() > 0 && !probeKeys.isValid(i)) return false;
+        key = probeScanner.int64At(i);
+        return true;
+    };
+    auto loadProbeValue = [&](size_t i, Value &key)
+    {
+        loadProbeKey(i, key);
+        return true;
+    };
+
+    // a build side over the memory budget is joined from disk, partition by
+    // partition; a side under SPILL_MIN_BUILD_BYTES and the deepest level
+    // join in memory whatever the budget
+    if (options.memoryBudget > 0 && spillDepth_ < MAX_SPILL_DEPTH)
+    {
+        size_t buildBytes = estimateBuildBytes(buildKeys, joinOnCodes, BUILD_BYTES_PER_ROW);
+        if (buildBytes > std::max(options.memoryBudget, SPILL_MIN_BUILD_BYTES))
+        {
+            DataType buildKeyType = joinOnCodes ? DataType::INTEGER : buildKeys.type();
+            DataType probeKeyType = joinOnCodes ? DataType::INTEGER : probeKeys.type();
+            return graceJoin(leftTable, rightTable, leftIsBuild, buildKeyType, probeKeyType, buildBytes,
+                             loadBuildKey, loadProbeKey, joinType, strategy, options);
+        }
     }
 
-    // BUILD PHASE
-    // ValueHasher hasher;
-    MurmurValueHasher hasher;
-    CustomHashTable<Value, size_t, MurmurValueHasher> hashTable(
-        buildTable->rowCount() * 2,
-        strategy,
-        hasher);
+    JoinArray<bool> buildMatched(buildTable->rowCount(), false);
 
-    // Build phase
-    for (size_t i = 0; i < buildTable->rowCount(); ++i)
+    // filled during the build, checked before every hash table lookup; both
+    // take the hash the table computes for the key anyway
+    std::unique_ptr<BloomFilter> filter;
+    if (options.useBloomFilter)
     {
-        const Value &joinKey = buildTable->getRow(i)[buildColIdx];
-        hashTable.insert(joinKey, i);
+        filter = std::make_unique<BloomFilter>(buildTable->rowCount());
     }
+    size_t filterPasses = 0;
+    size_t filterFalsePositives = 0;
 
-    profiler_.markBuildComplete();
-    profiler_.recordHashStats(hashTable.getStats());
+    // PROBE PHASE; shared by the build paths below. The lookup structure is
+    // keyed on the type of keyTag (Value or int64_t); loadKey(i, key) loads
+    // probe row i's key and returns false when it can't match anything.
+    auto probe = [&](const auto &hashTable, auto keyTag, auto &&loadKey)
+    {
+        using Key = decltype(keyTag);
+
+        // emits the output rows of one probe row. mayMatch is false when the
+        // key or the Bloom filter ruled a match out, and then h is not used.
+        auto resolve = [&](size_t probeIdx, const Key &probeKey, bool mayMatch, size_t h)
+        {
+            size_t matches = 0;
+            if (mayMatch)
+            {
+                matches = hashTable.forEachMatchHashed(probeKey, h, [&](size_t buildIdx)
+                {
+                    buildMatched[buildIdx] = true;
+
+                    if (leftIsBuild)
+                    {
+                        result.add(buildIdx, probeIdx);
+                    }
+                    else
+                    {
+                        result.add(probeIdx, buildIdx);
+                    }
+                });
+                if (filter)
+                {
+                    filterPasses++;
+                    if (matches == 0) filterFalsePositives++;
+                }
+            }
+
+            if (matches == 0 && (joinType == JoinType::LEFT_OUTER || joinType == JoinType::FULL_OUTER))
+            {
+                if (!leftIsBuild)
+                {
+                    result.add(probeIdx, JoinResult::NULL_ROW);
+                }
+            }
+        };
+
+        size_t batchSize = options.probeBatchSize;
+        if (batchSize <= 1)
+        {
+            Key probeKey;
+            for (size_t probeIdx = 0; probeIdx < probeTable->rowCount(); ++probeIdx)
+            {
+                bool mayMatch = loadKey(probeIdx, probeKey);
+                size_t h = mayMatch ? hashTable.hashOf(probeKey) : 0;
+                resolve(probeIdx, probeKey, mayMatch && (!filter || filter->mayContain(h)), h);
+            }
+            return;
+        }
+
+        // group prefetching: hash the whole batch in one call and prefetch
+        // its buckets, then the entries they point to, then resolve the
+        // batch in order
+        JoinArray<Key> keyValues(batchSize);
+        JoinArray<const Key *> keys(batchSize);
+        JoinArray<size_t> hashes(batchSize);
+        JoinArray<char> mayMatch(batchSize);
+        for (size_t base = 0; base < probeTable->rowCount(); base += batchSize)
+        {
+            size_t count = std::min(batchSize, probeTable->rowCount() - base);
+            for (size_t i = 0; i < count; ++i)
+            {
+                mayMatch[i] = loadKey(base + i, keyValues[i]);
+                keys[i] = &keyValues[i];
+            }
+            hashTable.hashOfBatch(keys.data(), count, hashes.data());
+            for (size_t i = 0; i < count; ++i)
+            {
+                mayMatch[i] = mayMatch[i] && (!filter || filter->mayContain(hashes[i]));
+                if (mayMatch[i]) hashTable.prefetchBucket(hashes[i]);
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (mayMatch[i]) hashTable.prefetchEntry(hashes[i]);
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                resolve(base + i, keyValues[i], mayMatch[i], hashes[i]);
+            }
+        }
+    };
+
+    auto recordBuildStats = [&](const auto &hashTable)
+    {
+        profiler_.markBuildComplete();
+        profiler_.recordHashStats(hashTable.getStats());
+        if (profiler_.wantsDetailedStats())
+        {
+            profiler_.recordDetailedStats(hashTable.computeDetailedStats());
+        }
+    };
 
-    // PROBE PHASE
-    std::vector<bool> buildMatched(buildTable->rowCount(), false);
+    // BUILD PHASE
+    size_t buildThreads = std::max<size_t>(options.buildThreads, 1);
 
-    for (size_t probeIdx = 0; probeIdx < probeTable->rowCount(); ++probeIdx)
+    // dense integer keys skip hashing altogether; the scan that checks
+    // the key range also builds the index. Dictionary codes are dense by
+    // construction.
+    std::string keyNote = !joinOnCodes ? "" : remapCodes ? "; remapped dictionary codes" : "; dictionary codes";
+    std::string fallbackNote = keyNote;
+    std::unique_ptr<DirectAddressTable> directTable;
+    if (options.directAddressing)
     {
-        const Value &probeKey = probeTable->getRow(probeIdx)[probeColIdx];
-        auto matchingBuildIndices = hashTable.find(probeKey);
+        std::string rejectReason;
+        directTable = joinOnCodes
+            ? DirectAddressTable::tryBuild(buildKeys.codeData(), buildTable->rowCount(), rejectReason)
+            : DirectAddressTable::tryBuild(*buildTable, buildColIdx, rejectReason);
+        fallbackNote += "; direct addressing skipped: " + rejectReason;
+    }
+    if (!options.hashFunction.empty())
+    {
+        fallbackNote += "; hash " + options.hashFunction;
+    }
 
-        if (!matchingBuildIndices.empty())
+    // JoinAlgorithm::RADIX: both sides become (key, row, hash) tuples,
+    // partitioned on the low hash bits; then each build partition gets a
+    // small bucket-chained table and its probe partition is run against it
+    // while both are in cache
+    auto radixJoin = [&](const auto &hasher)
+    {
+        filter.reset();
+        // INTEGER keys (codes included) compare inside the tuples; other keys
+        // are only hashed there and compared in the columns on a hash match
+        bool integerKeys = joinOnCodes ||
+                           (buildKeys.type() == DataType::INTEGER && probeKeys.type() == DataType::INTEGER &&
+                            buildKeys.nullCount() == 0 && probeKeys.nullCount() == 0);
+        unsigned bits = options.radixBits >= 0 ? static_cast<unsigned>(options.radixBits)
+                                               : RadixPartitions::bitsFor(buildTable->rowCount());
+        auto tuplesOf = [&](size_t rows, auto &&loadKey)
         {
-            for (size_t buildIdx : matchingBuildIndices)
+            RadixPartitions::Tuples tuples(rows);
+            Value key;
+            for (size_t i = 0; i < rows; ++i)
             {
-                buildMatched[buildIdx] = true;
+                loadKey(i, key);
+                uint64_t h = hasher(key);
+                tuples[i].key = integerKeys ? std::get<std::int64_t>(key.data) : static_cast<int64_t>(h);
+                tuples[i].row = static_cast<uint32_t>(i);
+                tuples[i].hash = static_cast<uint32_t>(h);
+            }
+            return tuples;
+        };
+        RadixPartitions buildParts(tuplesOf(buildTable->rowCount(), loadBuildKey), bits);
+        RadixPartitions probeParts(tuplesOf(probeTable->rowCount(), loadProbeKey), bits);
 
-                const Row &leftRow = leftIsBuild ? buildTable->getRow(buildIdx) : probeTable->getRow(probeIdx);
-                const Row &rightRow = leftIsBuild ? probeTable->getRow(probeIdx) : buildTable->getRow(buildIdx);
+        profiler_.recordBuildThreads(1);
+        profiler_.recordJoinPath("radix join (" + std::to_string(buildParts.partitionCount()) + " partitions, " +
+                                 std::to_string(buildParts.passes()) + " passes)" + fallbackNote);
+        profiler_.markBuildComplete();
 
-                result->addRow(combineRows(leftRow, rightRow));
+        RadixBucketTable hashTable;
+        HashTableStats stats;
+        Value buildKey, probeKey;
+        for (size_t p = 0; p < buildParts.partitionCount(); ++p)
+        {
+            const RadixTuple *probeTuples = probeParts.partition(p);
+            size_t probeCount = probeParts.partitionSize(p);
+            size_t buildCount = buildParts.partitionSize(p);
+            if (buildCount > 0)
+            {
+                hashTable.build(buildParts.partition(p), buildCount, buildParts.bits());
+                stats.totalBuckets += hashTable.bucketCount();
+                stats.usedBuckets += hashTable.usedBuckets();
+                stats.totalEntries += buildCount;
+            }
+            for (size_t i = 0; i < probeCount; ++i)
+            {
+                const RadixTuple &probeTuple = probeTuples[i];
+                size_t matches = 0;
+                bool probeLoaded = false;
+                if (buildCount > 0)
+                {
+                    hashTable.forEachCandidate(probeTuple.hash, [&](const RadixTuple &buildTuple)
+                    {
+                        if (buildTuple.key != probeTuple.key) return;
+                        if (!integerKeys)
+                        {
+                            if (!probeLoaded) loadProbeKeyAt(probeTuple.row, probeKey);
+                            probeLoaded = true;
+                            loadBuildKeyAt(buildTuple.row, buildKey);
+                            if (!(buildKey == probeKey)) return;
+                        }
+                        matches++;
+                        buildMatched[buildTuple.row] = true;
+                        if (leftIsBuild)
+                        {
+                            result.add(buildTuple.row, probeTuple.row);
+                        }
+                        else
+                        {
+                            result.add(probeTuple.row, buildTuple.row);
+                        }
+                    });
+                }
+                if (matches == 0 && !leftIsBuild &&
+                    (joinType == JoinType::LEFT_OUTER || joinType == JoinType::FULL_OUTER))
+                {
+                    result.add(probeTuple.row, JoinResult::NULL_ROW);
+                }
             }
         }
-        else if (joinType == JoinType::LEFT_OUTER || joinType == JoinType::FULL_OUTER)
+
+        // memory is the tuples of both sides plus the bucket table the
+        // partitions take turns in
+        stats.loadFactor = stats.totalBuckets > 0 ? static_cast<double>(stats.totalEntries) / stats.totalBuckets : 0.0;
+        stats.memoryUsage = buildParts.memoryUsage() + probeParts.memoryUsage() + hashTable.memoryUsage();
+        profiler_.recordHashStats(stats);
+    };
+
+    // the hashed paths; Hasher is fixed for the whole join, altHasher is the
+    // second hash for CUCKOO. Tables are keyed on the type of keyTag, and
+    // the loaders fill keys of that type: buildKeyOf in row order,
+    // buildKeyAt from any row, probeKeyOf as probe() takes it.
+    auto buildHashed = [&](const auto &hasher, const auto &altHasher, auto keyTag,
+                           auto &&buildKeyOf, auto &&buildKeyAt, auto &&probeKeyOf)
+    {
+        using Hasher = std::decay_t<decltype(hasher)>;
+        using Key = decltype(keyTag);
+        if (buildThreads > 1)
         {
-            if (!leftIsBuild)
+            profiler_.recordBuildThreads(buildThreads);
+            profiler_.recordJoinPath("concurrent hash table" + fallbackNote);
+            // rows are only read during the build, so workers share the table
+            ConcurrentHashTable<Key, size_t, Hasher> hashTable(
+                buildTable->rowCount(), buildThreads, hasher);
+            hashTable.insertRows(buildTable->rowCount(), [&](size_t i)
+            {
+                Key joinKey;
+                buildKeyAt(i, joinKey);
+                return joinKey;
+            },
+            [&](size_t, size_t h)
             {
-                const Row &leftRow = probeTable->getRow(probeIdx);
-                const Row nullRightRow = createNullRow(rightTable.columnCount());
-                result->addRow(combineRows(leftRow, nullRightRow));
+                if (filter) filter->addConcurrent(h);
+            });
+
+            recordBuildStats(hashTable);
+            probe(hashTable, keyTag, probeKeyOf);
+        }
+        else if (options.csrBuild)
+        {
+            profiler_.recordJoinPath(std::string("CSR hash table (") + collisionStrategyName(strategy) + ")" + fallbackNote);
+            // count rows per key first, then place all row ids in one array
+            dispatchStrategy(strategy, [&](auto fixed)
+            {
+                CsrHashTable<Key, Hasher, decltype(fixed)> hashTable(strategy, hasher, altHasher);
+                hashTable.build(buildTable->rowCount(), [&](size_t i)
+                {
+                    Key joinKey;
+                    buildKeyOf(i, joinKey);
+                    return joinKey;
+                },
+                [&](size_t, size_t h)
+                {
+                    if (filter) filter->add(h);
+                });
+
+                recordBuildStats(hashTable);
+                probe(hashTable, keyTag, probeKeyOf);
+            });
+        }
+        else
+        {
+            profiler_.recordJoinPath(std::string("hash table (") + collisionStrategyName(strategy) + ")" + fallbackNote);
+            // a table type specialized for the strategy; nothing is looked up
+            // until the build is done, so growth rehashes in one go
+            dispatchStrategy(strategy, [&](auto fixed)
+            {
+                using HashTable = CustomHashTable<Key, size_t, Hasher, decltype(fixed), BulkGrowth>;
+                // only a sizing hint; the table still grows if it has to
+                HashTable hashTable(HashTable::capacityFor(buildTable->rowCount()), strategy, hasher, altHasher);
+
+                // Build phase
+                Key joinKey;
+                for (size_t i = 0; i < buildTable->rowCount(); ++i)
+                {
+                    buildKeyOf(i, joinKey);
+                    size_t h = hashTable.hashOf(joinKey);
+                    hashTable.insertHashed(joinKey, h, i);
+                    if (filter) filter->add(h);
+                }
+
+                recordBuildStats(hashTable);
+                probe(hashTable, keyTag, probeKeyOf);
+            });
+        }
+    };
+
+    if (directTable)
+    {
+        // the presence bitmap is already an exact filter
+        filter.reset();
+        profiler_.recordBuildThreads(1);
+        profiler_.recordJoinPath("direct array (span " + std::to_string(directTable->span()) +
+                                 " from key " + std::to_string(directTable->minKey()) + ")" + keyNote);
+        recordBuildStats(*directTable);
+        if (int64Keys)
+        {
+            probe(*directTable, std::int64_t(), loadProbeInt64);
+        }
+        else
+        {
+            probe(*directTable, Value(), loadProbeValue);
+        }
+    }
+    else if (options.hashFunction.empty() && int64Keys && options.algorithm != JoinAlgorithm::RADIX)
+    {
+        // the kernel TypedValueHasher runs for INTEGER keys
+        fallbackNote += "; int64 keys";
+        buildHashed(Int64Hasher(), Int64Hasher(CUCKOO_ALT_SEED), std::int64_t(),
+                    loadBuildInt64, loadBuildInt64At, loadProbeInt64);
+    }
+    else
+    {
+        // Value keys, for STRING and DOUBLE joins and hash functions chosen
+        // by name
+        auto joinValues = [&](const auto &hasher, const auto &altHasher)
+        {
+            if (options.algorithm == JoinAlgorithm::RADIX)
+            {
+                radixJoin(hasher);
             }
+            else
+            {
+                buildHashed(hasher, altHasher, Value(), loadBuildKey, loadBuildKeyAt, loadProbeValue);
+            }
+        };
+        if (options.hashFunction.empty())
+        {
+            // ValueHasher hasher;
+            // kernels for the build column's type, picked once for the whole join
+            DataType keyType = joinOnCodes ? DataType::INTEGER : buildTable->getSchema()[buildColIdx].type;
+            joinValues(TypedValueHasher(keyType), TypedValueHasher(keyType, CUCKOO_ALT_SEED));
+        }
+        else
+        {
+            // throws for an unknown name
+            joinValues(DynamicValueHasher(HashFunctionFactory<Value>::create(options.hashFunction)),
+                       DynamicValueHasher(HashFunctionFactory<Value>::create(options.hashFunction, CUCKOO_ALT_SEED)));
         }
     }
 
@@ -153,21 +717,71 @@ std::unique_ptr<Table> JoinEngine::hashJoin(
             {
                 if (leftIsBuild)
                 {
-                    const Row &leftRow = buildTable->getRow(buildIdx);
-                    const Row nullRightRow = createNullRow(rightTable.columnCount());
-                    result->addRow(combineRows(leftRow, nullRightRow));
+                    result.add(buildIdx, JoinResult::NULL_ROW);
                 }
                 else
                 {
-                    const Row nullLeftRow = createNullRow(leftTable.columnCount());
-                    const Row &rightRow = buildTable->getRow(buildIdx);
-                    result->addRow(combineRows(nullLeftRow, rightRow));
+                    result.add(JoinResult::NULL_ROW, buildIdx);
                 }
             }
         }
     }
 
     profiler_.markProbeComplete();
+    if (filter)
+    {
+        profiler_.recordFilterStats(probeTable->rowCount(), filterPasses, filterFalsePositives, filter->memoryUsage());
+    }
+
+    return result;
+}
+
+JoinResult JoinEngine::hashJoinRowIds(
+    const Table &leftTable,
+    const std::string &leftColumn,
+    const Table &rightTable,
+    const std::string &rightColumn,
+    JoinType joinType,
+    CollisionStrategy strategy,
+    const JoinOptions &options)
+{
+    JoinResult result = joinRowIds(leftTable, leftColumn, rightTable, rightColumn, joinType, strategy, options);
+    profiler_.recordResults(result.rowCount(), leftTable.rowCount() * rightTable.rowCount());
+    profiler_.stopProfiling();
+    return result;
+}
+
+std::unique_ptr<Table> JoinEngine::hashJoin(
+    const Table &leftTable,
+    const std::string &leftColumn,
+    const Table &rightTable,
+    const std::string &rightColumn,
+    JoinType joinType,
+    CollisionStrategy strategy,
+    const JoinOptions &options)
+{
+    return hashJoin(leftTable, leftColumn, rightTable, rightColumn, {}, joinType, strategy, options);
+}
+
+std::unique_ptr<Table> JoinEngine::hashJoin(
+    const Table &leftTable,
+    const std::string &leftColumn,
+    const Table &rightTable,
+    const std::string &rightColumn,
+    const std::vector<OutputColumn> &output,
+    JoinType joinType,
+    CollisionStrategy strategy,
+    const JoinOptions &options)
+{
+    // an unknown output column fails before any work is done
+    JoinResult(leftTable, rightTable).materialize(output);
+
+    JoinResult rowIds = joinRowIds(leftTable, leftColumn, rightTable, rightColumn, joinType, strategy, options);
+
+    // only the requested columns are read, gathered one column at a time;
+    // the hash table itself holds nothing but row ids
+    auto result = rowIds.materialize(output);
+    profiler_.markMaterializeComplete();
     profiler_.recordResults(result->rowCount(), leftTable.rowCount() * rightTable.rowCount());
     profiler_.stopProfiling();
 
@@ -175,6 +789,11 @@ std::unique_ptr<Table> JoinEngine::hashJoin(
 }
 
 const Profiler &JoinEngine::getProfiler() const
+{
+    return profiler_;
+}
+
+Profiler &JoinEngine::getProfiler()
 {
     return profiler_;
 }
\ No newline at end of file
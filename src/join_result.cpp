@@ -0,0 +1,77 @@
+#include "JoinResult.h"
+#include <stdexcept>
+
+JoinResult::JoinResult(const Table& left, const Table& right)
+    : left_(&left), right_(&right) {}
+
+std::pair<const Table*, size_t> JoinResult::sourceOf(size_t column) const {
+    if (column < left_->columnCount()) return {left_, column};
+    return {right_, column - left_->columnCount()};
+}
+
+std::string JoinResult::getColumnName(size_t column) const {
+    auto [table, index] = sourceOf(column);
+    return (column < left_->columnCount() ? "L_" : "R_") + table->getSchema()[index].name;
+}
+
+std::optional<size_t> JoinResult::getColumnIndex(const std::string& name) const {
+    for (size_t column = 0; column < columnCount(); ++column) {
+        if (getColumnName(column) == name) return column;
+    }
+    return std::nullopt;
+}
+
+std::vector<size_t> JoinResult::resolveColumns(const std::vector<OutputColumn>& columns) const {
+    std::vector<size_t> indices;
+    for (const auto& output : columns) {
+        auto index = getColumnIndex(output.column);
+        if (!index) {
+            throw std::runtime_error("Result column not found: " + output.column);
+        }
+        indices.push_back(*index);
+    }
+    return indices;
+}
+
+Value JoinResult::getValue(size_t row, size_t column) const {
+    auto [table, index] = sourceOf(column);
+    uint32_t sourceRow = column < left_->columnCount() ? rows_[row].left : rows_[row].right;
+    return sourceRow == NULL_ROW ? Value() : table->getColumn(index).valueAt(sourceRow);
+}
+
+std::unique_ptr<Table> JoinResult::materialize(const std::vector<OutputColumn>& columns,
+                                               size_t begin, size_t end) const {
+    end = std::min(end, rows_.size());
+    begin = std::min(begin, end);
+
+    std::vector<OutputColumn> all;
+    if (columns.empty()) {
+        for (size_t column = 0; column < columnCount(); ++column) all.emplace_back(getColumnName(column));
+    }
+    const std::vector<OutputColumn>& outputs = columns.empty() ? all : columns;
+    std::vector<size_t> indices = resolveColumns(outputs);
+    auto table = std::make_unique<Table>("JoinResult");
+    for (size_t i = 0; i < indices.size(); ++i) {
+        size_t column = indices[i];
+        auto [source, index] = sourceOf(column);
+        const Column& input = source->getColumn(index);
+        bool fromLeft = column < left_->columnCount();
+
+        // one column at a time: a gather from a single input array
+        Column output(input.type());
+        if (input.isDictionaryEncoded()) {
+            output.encodeDictionary(input.dictionary());
+        }
+        output.reserve(end - begin);
+        for (size_t row = begin; row < end; ++row) {
+            uint32_t sourceRow = fromLeft ? rows_[row].left : rows_[row].right;
+            if (sourceRow == NULL_ROW) {
+                output.appendNull();
+            } else {
+                output.appendFrom(input, sourceRow);
+            }
+        }
+        table->addColumn(outputs[i].alias.empty() ? outputs[i].column : outputs[i].alias, std::move(output));
+    }
+    return table;
+}
@@ -0,0 +1,35 @@
+#include "MemoryTracker.h"
+
+MemoryTracker::Slot MemoryTracker::slots_[MEMORY_COMPONENT_COUNT + 1];
+
+const char* memoryComponentName(MemoryComponent component) {
+    switch (component) {
+        case MemoryComponent::TABLE: return "table";
+        case MemoryComponent::ROW: return "row";
+        case MemoryComponent::HASH_TABLE: return "hash table";
+        case MemoryComponent::JOIN: return "join";
+    }
+    return "unknown";
+}
+
+MemoryCounters MemoryTracker::read(const Slot& slot) {
+    MemoryCounters counters;
+    counters.current = slot.current.load(std::memory_order_relaxed);
+    counters.peak = slot.peak.load(std::memory_order_relaxed);
+    counters.allocations = slot.allocations.load(std::memory_order_relaxed);
+    return counters;
+}
+
+MemoryCounters MemoryTracker::counters(MemoryComponent component) {
+    return read(slots_[static_cast<size_t>(component)]);
+}
+
+MemoryCounters MemoryTracker::total() {
+    return read(slots_[MEMORY_COMPONENT_COUNT]);
+}
+
+void MemoryTracker::resetPeaks() {
+    for (Slot& slot : slots_) {
+        slot.peak.store(slot.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
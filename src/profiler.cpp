@@ -3,16 +3,43 @@
 #include <iostream>
 #include <iomanip>
 
+void Profiler::readTracker(MemoryCounters* counters) {
+    for (size_t c = 0; c < MEMORY_COMPONENT_COUNT; ++c) {
+        counters[c] = MemoryTracker::counters(static_cast<MemoryComponent>(c));
+    }
+    counters[MEMORY_COMPONENT_COUNT] = MemoryTracker::total();
+}
+
+// the tracker's peaks are process-wide, so phase peaks are exact only while
+// this is the one join allocating
+void Profiler::recordMemoryPhase(MemoryPhase phase) {
+    MemoryCounters now[MEMORY_COMPONENT_COUNT + 1];
+    readTracker(now);
+    for (size_t c = 0; c <= MEMORY_COMPONENT_COUNT; ++c) {
+        PhaseMemory& memory = data_.memory[phase][c];
+        memory.peakBytes = now[c].peak > joinStart_[c].current ? now[c].peak - joinStart_[c].current : 0;
+        memory.netBytes = static_cast<long long>(now[c].current) - static_cast<long long>(joinStart_[c].current);
+        memory.allocations = now[c].allocations - phaseStart_[c].allocations;
+        phaseStart_[c] = now[c];
+    }
+    data_.peakMemoryUsage = std::max(data_.peakMemoryUsage, data_.memory[phase][MEMORY_COMPONENT_COUNT].peakBytes);
+    if (!nested_) MemoryTracker::resetPeaks();
+}
+
 void Profiler::startProfiling() {
     profiling_ = true;
     startTime_ = std::chrono::high_resolution_clock::now();
     data_ = Profiler::ProfileData{};
+    if (!nested_) MemoryTracker::resetPeaks();
+    readTracker(joinStart_);
+    std::copy(joinStart_, joinStart_ + MEMORY_COMPONENT_COUNT + 1, phaseStart_);
 }
 
 void Profiler::markBuildComplete() {
     if(!profiling_) return;
     auto now = std::chrono::high_resolution_clock::now();
     data_.buildTime = std::chrono::duration_cast<std::chrono::nanoseconds>(now - startTime_);
+    recordMemoryPhase(BUILD_PHASE);
 }
 
 void Profiler::markProbeComplete() {
@@ -20,12 +47,67 @@ void Profiler::markProbeComplete() {
     auto now = std::chrono::high_resolution_clock::now();
     data_.probeTime = std::chrono::duration_cast<std::chrono::nanoseconds>(now - startTime_) - data_.buildTime;
     data_.totalTime = data_.buildTime + data_.probeTime;
+    recordMemoryPhase(PROBE_PHASE);
+}
+
+void Profiler::markMaterializeComplete() {
+    if(!profiling_) return;
+    auto now = std::chrono::high_resolution_clock::now();
+    data_.totalTime = std::chrono::duration_cast<std::chrono::nanoseconds>(now - startTime_);
+    data_.materializeTime = data_.totalTime - data_.buildTime - data_.probeTime;
+    recordMemoryPhase(MATERIALIZE_PHASE);
 }
 
 void Profiler::recordHashStats(const HashTableStats& stats) {
     data_.hashStats = stats;
     data_.memoryUsage = stats.memoryUsage;
-    data_.peakMemoryUsage = std::max(data_.peakMemoryUsage, stats.memoryUsage);
+}
+
+void Profiler::recordBuildThreads(size_t threads) {
+    data_.buildThreads = threads;
+}
+
+void Profiler::recordJoinPath(const std::string& path) {
+    data_.joinPath = path;
+}
+
+void Profiler::setDetailedStats(bool enabled) {
+    detailedStats_ = enabled;
+}
+
+bool Profiler::wantsDetailedStats() const {
+    return detailedStats_;
+}
+
+void Profiler::recordDetailedStats(const DetailedHashTableStats& stats) {
+    data_.detailedHashStats = stats;
+    data_.hasDetailedHashStats = true;
+}
+
+static void printHistogram(const char* title, const std::vector<size_t>& histogram) {
+    std::cout << title << "\n";
+    for (size_t i = 0; i < histogram.size(); ++i) {
+        if (histogram[i] == 0) continue;
+        std::cout << "  " << std::setw(6) << i << ": " << histogram[i] << "\n";
+    }
+}
+
+void Profiler::recordFilterStats(size_t probes, size_t passes, size_t falsePositives, size_t memory) {
+    data_.usedBloomFilter = true;
+    data_.filterProbes = probes;
+    data_.filterPasses = passes;
+    data_.filterFalsePositives = falsePositives;
+    data_.filterMemory = memory;
+}
+
+void Profiler::recordSpill(size_t partitions, size_t bytes, size_t depth) {
+    data_.spillPartitions += partitions;
+    data_.spillBytes += bytes;
+    data_.spillDepth = std::max(data_.spillDepth, depth);
+}
+
+void Profiler::setNested(bool nested) {
+    nested_ = nested;
 }
 
 void Profiler::recordResults(size_t resultRows, size_t totalPossibleRows){
@@ -49,10 +131,33 @@ void Profiler::printReport() const {
     std::cout << "\n=== Performance Report ===\n";
         std::cout << std::fixed << std::setprecision(3);
         std::cout << "Build Time:     " << data_.buildTime.count() / 1e6 << " ms\n";
+        std::cout << "Join Path:      " << data_.joinPath << "\n";
+        std::cout << "Build Threads:  " << data_.buildThreads << "\n";
         std::cout << "Probe Time:     " << data_.probeTime.count() / 1e6 << " ms\n";
+        std::cout << "Materialize:    " << data_.materializeTime.count() / 1e6 << " ms\n";
         std::cout << "Total Time:     " << data_.totalTime.count() / 1e6 << " ms\n";
         std::cout << "Result Rows:    " << data_.resultRows << "\n";
         std::cout << "Selectivity:    " << data_.selectivity * 100 << "%\n";
+
+        if (data_.usedBloomFilter) {
+            // false-positive rate is over the probes whose key is not in the build side
+            size_t truePositives = data_.filterPasses - data_.filterFalsePositives;
+            size_t negatives = data_.filterProbes - truePositives;
+            std::cout << "\n=== Bloom Filter ===\n";
+            std::cout << "Filter Probes:  " << data_.filterProbes << "\n";
+            std::cout << "Filter Hits:    " << (data_.filterProbes > 0 ?
+                100.0 * data_.filterPasses / data_.filterProbes : 0.0) << "%\n";
+            std::cout << "False Pos Rate: " << (negatives > 0 ?
+                100.0 * data_.filterFalsePositives / negatives : 0.0) << "%\n";
+            std::cout << "Filter Memory:  " << data_.filterMemory / 1024 << " KB\n";
+        }
+
+        if (data_.spillPartitions > 0) {
+            std::cout << "\n=== Spilling ===\n";
+            std::cout << "Partitions:     " << data_.spillPartitions << "\n";
+            std::cout << "Spilled:        " << data_.spillBytes / 1024 << " KB\n";
+            std::cout << "Levels:         " << data_.spillDepth << "\n";
+        }
         
         std::cout << "\n=== Hash Table Statistics ===\n";
         std::cout << "Total Buckets:  " << data_.hashStats.totalBuckets << "\n";
@@ -61,6 +166,35 @@ void Profiler::printReport() const {
         std::cout << "Collisions:     " << data_.hashStats.collisions << "\n";
         std::cout << "Avg Chain Len:  " << data_.hashStats.avgChainLength << "\n";
         std::cout << "Max Chain Len:  " << data_.hashStats.maxChainLength << "\n";
+        std::cout << "Avg Probe Dist: " << data_.hashStats.avgProbeDistance << "\n";
+        std::cout << "Max Probe Dist: " << data_.hashStats.maxProbeDistance << "\n";
+        std::cout << "Resizes:        " << data_.hashStats.resizes << "\n";
         std::cout << "Memory Usage:   " << data_.hashStats.memoryUsage / 1024 << " KB\n";
+        if (data_.hasDetailedHashStats) {
+            printHistogram("Chain Length Histogram:", data_.detailedHashStats.chainLengthHistogram);
+            printHistogram("Probe Distance Histogram:", data_.detailedHashStats.probeDistanceHistogram);
+        }
+
+        // bytes above what was live when the join started
+        static const char* phaseNames[MEMORY_PHASE_COUNT] = {"Build", "Probe", "Materialize"};
+        std::cout << "\n=== Tracked Memory ===\n";
+        std::cout << "Peak Memory:    " << data_.peakMemoryUsage / 1024 << " KB\n";
+        std::cout << std::left << std::setw(13) << "Phase" << std::setw(12) << "Component"
+                  << std::right << std::setw(12) << "Peak KB" << std::setw(12) << "Net KB"
+                  << std::setw(10) << "Allocs" << "\n";
+        for (size_t phase = 0; phase < MEMORY_PHASE_COUNT; ++phase) {
+            // the phase total first, then the components that saw any use
+            for (size_t k = 0; k <= MEMORY_COMPONENT_COUNT; ++k) {
+                size_t c = k == 0 ? MEMORY_COMPONENT_COUNT : k - 1;
+                const PhaseMemory& memory = data_.memory[phase][c];
+                if (k > 0 && memory.allocations == 0 && memory.peakBytes == 0 && memory.netBytes == 0) continue;
+                std::cout << std::left << std::setw(13) << (k == 0 ? phaseNames[phase] : "")
+                          << std::setw(12) << (c == MEMORY_COMPONENT_COUNT ? "all" :
+                                               memoryComponentName(static_cast<MemoryComponent>(c)))
+                          << std::right << std::setprecision(1) << std::setw(12) << memory.peakBytes / 1024.0
+                          << std::setw(12) << memory.netBytes / 1024.0
+                          << std::setw(10) << memory.allocations << "\n";
+            }
+        }
         std::cout << "========================\n\n";
 }
\ No newline at end of file
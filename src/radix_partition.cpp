@@ -0,0 +1,104 @@
+#include "RadixPartition.h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+namespace {
+
+constexpr size_t CACHE_LINE = 64;
+constexpr size_t TUPLES_PER_LINE = CACHE_LINE / sizeof(RadixTuple);
+
+struct alignas(CACHE_LINE) TupleLine {
+    RadixTuple tuples[TUPLES_PER_LINE];
+};
+
+} // namespace
+
+unsigned RadixPartitions::bitsFor(size_t buildRows) {
+    size_t bytes = buildRows * BUILD_BYTES_PER_TUPLE;
+    unsigned bits = 0;
+    while (bits < MAX_BITS && (bytes >> bits) > CACHE_BYTES) bits++;
+    return bits;
+}
+
+RadixPartitions::RadixPartitions(Tuples tuples, unsigned bits)
+    : tuples_(std::move(tuples)),
+      bits_(std::min(bits, MAX_BITS)),
+      passes_((bits_ + MAX_BITS_PER_PASS - 1) / MAX_BITS_PER_PASS) {
+    offsets_ = {0, tuples_.size()};
+    if (bits_ == 0) return;
+
+    Tuples scratch(tuples_.size());
+    size_t bounds[(size_t(1) << MAX_BITS_PER_PASS) + 1];
+    unsigned shift = 0;
+    for (unsigned pass = 0; pass < passes_; ++pass) {
+        // the bits split as evenly as the passes allow
+        unsigned passBits = (bits_ - shift + (passes_ - pass) - 1) / (passes_ - pass);
+        size_t fanout = size_t(1) << passBits;
+
+        TrackedVector<size_t, MemoryComponent::HASH_TABLE> split;
+        split.reserve(partitionCount() * fanout + 1);
+        for (size_t p = 0; p < partitionCount(); ++p) {
+            size_t begin = offsets_[p];
+            scatter(tuples_.data() + begin, partitionSize(p), scratch.data() + begin, shift, passBits, bounds);
+            for (size_t q = 0; q < fanout; ++q) split.push_back(begin + bounds[q]);
+        }
+        split.push_back(tuples_.size());
+
+        tuples_.swap(scratch);
+        offsets_.swap(split);
+        shift += passBits;
+    }
+}
+
+void RadixPartitions::scatter(const RadixTuple* in, size_t n, RadixTuple* out,
+                              unsigned shift, unsigned bits, size_t* bounds) {
+    size_t fanout = size_t(1) << bits;
+    uint32_t mask = static_cast<uint32_t>(fanout - 1);
+
+    size_t next[size_t(1) << MAX_BITS_PER_PASS] = {};
+    for (size_t i = 0; i < n; ++i) next[(in[i].hash >> shift) & mask]++;
+    size_t sum = 0;
+    for (size_t p = 0; p < fanout; ++p) {
+        bounds[p] = sum;
+        sum += next[p];
+        next[p] = bounds[p];
+    }
+    bounds[fanout] = n;
+
+    // tuples gather in a line per partition (all of them fit in L1) and go
+    // out a whole line at a time
+    std::unique_ptr<TupleLine[]> lines(new TupleLine[fanout]);
+    uint8_t fill[size_t(1) << MAX_BITS_PER_PASS] = {};
+    for (size_t i = 0; i < n; ++i) {
+        size_t p = (in[i].hash >> shift) & mask;
+        lines[p].tuples[fill[p]++] = in[i];
+        if (fill[p] == TUPLES_PER_LINE) {
+            std::memcpy(out + next[p], lines[p].tuples, sizeof(TupleLine));
+            next[p] += TUPLES_PER_LINE;
+            fill[p] = 0;
+        }
+    }
+    for (size_t p = 0; p < fanout; ++p) {
+        if (fill[p] > 0) std::memcpy(out + next[p], lines[p].tuples, fill[p] * sizeof(RadixTuple));
+    }
+}
+
+void RadixBucketTable::build(const RadixTuple* tuples, size_t count, unsigned radixBits) {
+    size_t buckets = 1;
+    while (buckets < count) buckets <<= 1;
+    heads_.assign(buckets, 0);
+    next_.resize(count);
+    tuples_ = tuples;
+    shift_ = radixBits;
+    mask_ = buckets - 1;
+    usedBuckets_ = 0;
+
+    // pushed in reverse, so each chain lists its tuples in row order
+    for (size_t i = count; i-- > 0;) {
+        uint32_t& head = heads_[(tuples[i].hash >> shift_) & mask_];
+        if (head == 0) usedBuckets_++;
+        next_[i] = head;
+        head = static_cast<uint32_t>(i + 1);
+    }
+}
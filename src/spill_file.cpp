@@ -0,0 +1,120 @@
+#include "SpillFile.h"
+#include <atomic>
+#include <cstdio>
+#include <stdexcept>
+#include <unistd.h>
+
+// record: uint32 row id, uint8 tag, then an int64, a double, a uint32
+// length and the bytes of a string, or nothing for NULL
+namespace {
+
+enum KeyTag : uint8_t { NULL_KEY, INTEGER_KEY, DOUBLE_KEY, STRING_KEY };
+
+std::atomic<size_t> nextSpillId{0};
+
+template<typename T>
+bool readRaw(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+} // namespace
+
+SpillFile::SpillFile(const std::string& directory, DataType keyType)
+    : path_(directory + "/bifrost-spill-" + std::to_string(::getpid()) + "-" +
+            std::to_string(nextSpillId.fetch_add(1))),
+      keyType_(keyType),
+      out_(path_, std::ios::binary | std::ios::trunc) {
+    if (!out_) throw std::runtime_error("Cannot create spill file: " + path_);
+}
+
+SpillFile::~SpillFile() {
+    out_.close();
+    std::remove(path_.c_str());
+}
+
+void SpillFile::append(uint32_t row, const Value& key) {
+    out_.write(reinterpret_cast<const char*>(&row), sizeof(row));
+    uint8_t tag = NULL_KEY;
+    size_t bytes = sizeof(row) + sizeof(tag);
+    switch (key.getType()) {
+        case DataType::INTEGER: {
+            tag = INTEGER_KEY;
+            out_.write(reinterpret_cast<const char*>(&tag), sizeof(tag));
+            int64_t value = std::get<std::int64_t>(key.data);
+            out_.write(reinterpret_cast<const char*>(&value), sizeof(value));
+            bytes += sizeof(value);
+            break;
+        }
+        case DataType::DOUBLE: {
+            tag = DOUBLE_KEY;
+            out_.write(reinterpret_cast<const char*>(&tag), sizeof(tag));
+            double value = std::get<double>(key.data);
+            out_.write(reinterpret_cast<const char*>(&value), sizeof(value));
+            bytes += sizeof(value);
+            break;
+        }
+        case DataType::STRING: {
+            tag = STRING_KEY;
+            out_.write(reinterpret_cast<const char*>(&tag), sizeof(tag));
+            const std::string& value = std::get<std::string>(key.data);
+            uint32_t length = static_cast<uint32_t>(value.size());
+            out_.write(reinterpret_cast<const char*>(&length), sizeof(length));
+            out_.write(value.data(), length);
+            bytes += sizeof(length) + length;
+            break;
+        }
+        default:
+            out_.write(reinterpret_cast<const char*>(&tag), sizeof(tag));
+            break;
+    }
+    if (!out_) throw std::runtime_error("Cannot write spill file: " + path_);
+    rowCount_++;
+    bytesWritten_ += bytes;
+}
+
+std::unique_ptr<Table> SpillFile::readTable(const std::string& name) {
+    out_.close();
+    if (!out_) throw std::runtime_error("Cannot write spill file: " + path_);
+
+    std::ifstream in(path_, std::ios::binary);
+    if (!in) throw std::runtime_error("Cannot read spill file: " + path_);
+
+    Column keys(keyType_);
+    Column rows(DataType::INTEGER);
+    keys.reserve(rowCount_);
+    rows.reserve(rowCount_);
+    Value key;
+    std::string text;
+    for (size_t i = 0; i < rowCount_; ++i) {
+        uint32_t row;
+        uint8_t tag;
+        bool ok = readRaw(in, row) && readRaw(in, tag);
+        if (ok && tag == INTEGER_KEY) {
+            int64_t value;
+            ok = readRaw(in, value);
+            key.data = value;
+        } else if (ok && tag == DOUBLE_KEY) {
+            double value;
+            ok = readRaw(in, value);
+            key.data = value;
+        } else if (ok && tag == STRING_KEY) {
+            uint32_t length;
+            ok = readRaw(in, length);
+            text.resize(ok ? length : 0);
+            ok = ok && in.read(text.data(), text.size());
+            key.data = text;
+        } else if (ok && tag == NULL_KEY) {
+            key.data = std::monostate{};
+        } else {
+            ok = false;
+        }
+        if (!ok) throw std::runtime_error("Corrupt spill file: " + path_);
+        keys.append(key);
+        rows.append(Value(static_cast<std::int64_t>(row)));
+    }
+
+    auto table = std::make_unique<Table>(name);
+    table->addColumn("key", std::move(keys));
+    table->addColumn("row", std::move(rows));
+    return table;
+}
@@ -1,22 +1,112 @@
 #include "Table.h"
+#include <cmath>
 #include <iostream>
 #include <algorithm>
 #include <variant>
 #include <string>
 
+size_t RowView::size() const {
+    return table_->columnCount();
+}
+
+Value RowView::getValue(size_t column) const {
+    return table_->getColumn(column).valueAt(index_);
+}
+
+std::string RowView::toString() const {
+    return toRow().toString();
+}
+
+Row::Values RowView::getValues() const {
+    Row::Values values;
+    values.reserve(size());
+    for (size_t col = 0; col < size(); ++col) {
+        values.push_back(getValue(col));
+    }
+    return values;
+}
+
+Row RowView::toRow() const {
+    return Row(getValues());
+}
+
+size_t RowRange::size() const {
+    return table_->rowCount();
+}
+
+void Table::addColumn(const std::string& name, DataType type) {
+    schema_.push_back({name, type, schema_.size()});
+    columns_.emplace_back(type);
+    columns_.back().reserve(rowCount_);
+    for (size_t i = 0; i < rowCount_; ++i) {
+        columns_.back().appendNull();
+    }
+}
+
+void Table::addColumn(const std::string& name, Column column) {
+    if (!columns_.empty() && column.size() != rowCount_) {
+        throw std::runtime_error("Column size doesn't match table");
+    }
+    schema_.push_back({name, column.type(), schema_.size()});
+    rowCount_ = column.size();
+    columns_.push_back(std::move(column));
+}
+
+// value as a column of type stores it: numbers convert when the conversion
+// is exact, anything else the column can't hold becomes NULL
+static Value coerceCell(const Value& value, DataType type) {
+    if (value.isNull() || value.getType() == type) return value;
+    if (type == DataType::DOUBLE && value.getType() == DataType::INTEGER) {
+        auto i = std::get<std::int64_t>(value.data);
+        double d = static_cast<double>(i);
+        if (d < 9223372036854775808.0 && static_cast<std::int64_t>(d) == i) return Value(d);
+    }
+    if (type == DataType::INTEGER && value.getType() == DataType::DOUBLE) {
+        double d = std::get<double>(value.data);
+        if (std::trunc(d) == d && d >= -9223372036854775808.0 && d < 9223372036854775808.0) {
+            return Value(static_cast<std::int64_t>(d));
+        }
+    }
+    return Value();
+}
+
 void Table::addRow(const Row& row) {
     if (row.size() != schema_.size()) {
         throw std::runtime_error("Row size doesn't match schema");
     }
-    rows_.push_back(row);
+    for (size_t col = 0; col < row.size(); ++col) {
+        const Value& cell = row[col];
+        if (cell.isNull() || cell.getType() == schema_[col].type) {
+            columns_[col].append(cell);
+        } else {
+            columns_[col].append(coerceCell(cell, schema_[col].type));
+        }
+    }
+    rowCount_++;
 }
 
-const Row& Table::getRow(size_t index) const {
-    return rows_[index];
+RowView Table::getRow(size_t index) const {
+    return RowView(*this, index);
+}
+
+void Table::encodeColumn(size_t index, std::shared_ptr<StringDictionary> dictionary) {
+    columns_.at(index).encodeDictionary(std::move(dictionary));
+}
+
+void Table::compressColumns() {
+    for (auto& column : columns_) {
+        column.compress();
+    }
+}
+
+void Table::reserve(size_t rows) {
+    for (auto& column : columns_) {
+        column.reserve(rows);
+    }
 }
 
 size_t Table::rowCount() const { 
-    return rows_.size(); 
+    return rowCount_; 
 }
 
 size_t Table::columnCount() const { 
@@ -27,10 +117,6 @@ const std::vector<ColumnInfo>& Table::getSchema() const {
     return schema_; 
 }
 
-const std::vector<Row>& Table::getRows() const { 
-    return rows_; 
-}
-
 const std::string& Table::getName() const { 
     return name_; 
 }
@@ -44,20 +130,17 @@ std::optional<size_t> Table::getColumnIndex(const std::string& colName) const {
 size_t Table::estimateMemoryUsage() const {
     size_t total = sizeof(*this);
     total += schema_.capacity() * sizeof(ColumnInfo);
-    total += rows_.capacity() * sizeof(Row);
-    
-    for (const auto& row : rows_) {
-        for (const auto& value : row.getValues()) {
-            if (std::holds_alternative<std::string>(value.data)) {
-                total += std::get<std::string>(value.data).capacity();
-            }
-        }
+    for (const auto& column : columns_) {
+        total += column.memoryUsage();
     }
     return total;
 }
 
 void Table::clear() {
-    rows_.clear();
+    for (auto& column : columns_) {
+        column.clear();
+    }
+    rowCount_ = 0;
 }
 
 void Table::printSchema() const {
@@ -72,12 +155,12 @@ void Table::printSchema() const {
 
 void Table::printSample(size_t maxRows) const {
     printSchema();
-    std::cout << "Sample data (" << std::min(maxRows, rows_.size()) << " rows):" << std::endl;
-    for (size_t i = 0; i < std::min(maxRows, rows_.size()); ++i) {
-        std::cout << "  " << rows_[i].toString() << std::endl;
+    std::cout << "Sample data (" << std::min(maxRows, rowCount_) << " rows):" << std::endl;
+    for (size_t i = 0; i < std::min(maxRows, rowCount_); ++i) {
+        std::cout << "  " << getRow(i).toString() << std::endl;
     }
-    if (rows_.size() > maxRows) {
-        std::cout << "  ... (" << (rows_.size() - maxRows) << " more rows)" << std::endl;
+    if (rowCount_ > maxRows) {
+        std::cout << "  ... (" << (rowCount_ - maxRows) << " more rows)" << std::endl;
     }
     std::cout << std::endl;
 }
@@ -0,0 +1,316 @@
+#include "Table.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ Snapshot file layout (version 1), all integers in the writer's byte order:
+
+   SnapshotHeader
+   SnapshotColumn    x columnCount
+   SnapshotDictionary x dictionaryCount
+   blocks, each starting on a 64-byte boundary:
+     names       table name then column names, back to back
+     per column  validity bitmap, values (int64/double/uint32 codes, or
+                 uint64 offsets for a plain STRING), string bytes; a
+                 NULL_VALUE column (every row NULL) has the bitmap only
+     per dictionary  uint64 offsets (count + 1), string bytes
+
+ The blocks hold the arrays exactly as Column keeps them in memory, so an
+ opened snapshot serves its columns straight out of the mapping. Columns
+ sharing a dictionary point at the same SnapshotDictionary. Opening checks
+ the header and that every block lies inside the file, but not each row's
+ string offset or code.
+*/
+
+namespace {
+
+constexpr char SNAPSHOT_MAGIC[8] = {'B', 'F', 'S', 'N', 'A', 'P', '\0', '\0'};
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr uint32_t NO_DICTIONARY = UINT32_MAX;
+constexpr uint64_t BLOCK_ALIGN = 64;
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t fileSize;
+    uint64_t rowCount;
+    uint32_t columnCount;
+    uint32_t dictionaryCount;
+    uint64_t nameOffset;
+    uint64_t nameLength;
+};
+
+struct SnapshotColumn {
+    uint64_t nameOffset;
+    uint64_t nameLength;
+    uint32_t type;
+    uint32_t dictionary;
+    uint64_t nullCount;
+    uint64_t validityOffset;
+    uint64_t valuesOffset;
+    uint64_t bytesOffset;
+    uint64_t bytesLength;
+};
+
+struct SnapshotDictionary {
+    uint64_t count;
+    uint64_t offsetsOffset;
+    uint64_t bytesOffset;
+    uint64_t bytesLength;
+};
+
+class SnapshotWriter {
+    private:
+        std::ofstream out_;
+        uint64_t position_ = 0;
+
+    public:
+        explicit SnapshotWriter(const std::string& path) : out_(path, std::ios::binary | std::ios::trunc) {
+            if (!out_) throw std::runtime_error("Cannot write snapshot: " + path);
+        }
+
+        // writes size bytes at the next block boundary, returns their offset
+        uint64_t block(const void* data, size_t size) {
+            static const char padding[BLOCK_ALIGN] = {};
+            uint64_t aligned = (position_ + BLOCK_ALIGN - 1) / BLOCK_ALIGN * BLOCK_ALIGN;
+            out_.write(padding, aligned - position_);
+            if (size > 0) out_.write(static_cast<const char*>(data), size);
+            position_ = aligned + size;
+            return aligned;
+        }
+
+        void at(uint64_t offset, const void* data, size_t size) {
+            out_.seekp(offset);
+            out_.write(static_cast<const char*>(data), size);
+            out_.seekp(position_);
+        }
+
+        uint64_t position() const { return position_; }
+
+        void finish(const std::string& path) {
+            out_.close();
+            if (!out_) throw std::runtime_error("Cannot write snapshot: " + path);
+        }
+};
+
+[[noreturn]] void corrupt(const std::string& path, const std::string& reason) {
+    throw std::runtime_error("Corrupt snapshot: " + path + " (" + reason + ")");
+}
+
+} // namespace
+
+void Table::saveSnapshot(const std::string& path) const {
+    SnapshotWriter writer(path);
+
+    // shared dictionaries are written once
+    std::vector<const StringDictionary*> dictionaries;
+    std::vector<SnapshotColumn> entries(columns_.size());
+    for (size_t col = 0; col < columns_.size(); ++col) {
+        entries[col].dictionary = NO_DICTIONARY;
+        if (!columns_[col].isDictionaryEncoded()) continue;
+        const StringDictionary* dictionary = columns_[col].dictionary().get();
+        auto it = std::find(dictionaries.begin(), dictionaries.end(), dictionary);
+        entries[col].dictionary = static_cast<uint32_t>(it - dictionaries.begin());
+        if (it == dictionaries.end()) dictionaries.push_back(dictionary);
+    }
+
+    SnapshotHeader header = {};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.rowCount = rowCount_;
+    header.columnCount = static_cast<uint32_t>(columns_.size());
+    header.dictionaryCount = static_cast<uint32_t>(dictionaries.size());
+
+    // header and directory are filled in once the block offsets are known
+    std::vector<SnapshotDictionary> dictionaryEntries(dictionaries.size());
+    size_t directorySize = sizeof(SnapshotHeader) + entries.size() * sizeof(SnapshotColumn) +
+                           dictionaryEntries.size() * sizeof(SnapshotDictionary);
+    std::vector<char> placeholder(directorySize);
+    writer.block(placeholder.data(), placeholder.size());
+
+    std::string names = name_;
+    for (const auto& info : schema_) names += info.name;
+    uint64_t namesOffset = writer.block(names.data(), names.size());
+    header.nameOffset = namesOffset;
+    header.nameLength = name_.size();
+    uint64_t nameOffset = namesOffset + name_.size();
+    for (size_t col = 0; col < columns_.size(); ++col) {
+        entries[col].nameOffset = nameOffset;
+        entries[col].nameLength = schema_[col].name.size();
+        nameOffset += schema_[col].name.size();
+    }
+
+    for (size_t col = 0; col < columns_.size(); ++col) {
+        const Column& column = columns_[col];
+        SnapshotColumn& entry = entries[col];
+        size_t rows = column.size();
+        entry.type = static_cast<uint32_t>(column.type());
+        entry.nullCount = column.nullCount();
+        entry.validityOffset = writer.block(column.validityData(), (rows + 63) / 64 * sizeof(uint64_t));
+        switch (column.type()) {
+            case DataType::INTEGER:
+                if (column.int64Data()) {
+                    entry.valuesOffset = writer.block(column.int64Data(), rows * sizeof(int64_t));
+                } else {
+                    // compressed columns are written plain
+                    std::vector<int64_t> values(rows);
+                    column.decodeInt64(0, rows, values.data());
+                    for (size_t i = 0; i < rows; ++i) {
+                        if (!column.isValid(i)) values[i] = 0;
+                    }
+                    entry.valuesOffset = writer.block(values.data(), rows * sizeof(int64_t));
+                }
+                break;
+            case DataType::DOUBLE:
+                entry.valuesOffset = writer.block(column.doubleData(), rows * sizeof(double));
+                break;
+            case DataType::STRING:
+                if (column.isDictionaryEncoded()) {
+                    entry.valuesOffset = writer.block(column.codeData(), rows * sizeof(uint32_t));
+                } else {
+                    entry.valuesOffset = writer.block(column.stringOffsets(), (rows + 1) * sizeof(uint64_t));
+                    entry.bytesLength = column.stringOffsets()[rows];
+                    entry.bytesOffset = writer.block(column.stringBytes(), entry.bytesLength);
+                }
+                break;
+            case DataType::NULL_VALUE:
+                // every row NULL: the validity bitmap says it all
+                break;
+        }
+    }
+
+    for (size_t d = 0; d < dictionaries.size(); ++d) {
+        const StringDictionary& dictionary = *dictionaries[d];
+        std::vector<uint64_t> offsets = {0};
+        std::string bytes;
+        for (uint32_t code = 0; code < dictionary.size(); ++code) {
+            bytes += dictionary.at(code);
+            offsets.push_back(bytes.size());
+        }
+        dictionaryEntries[d].count = dictionary.size();
+        dictionaryEntries[d].offsetsOffset = writer.block(offsets.data(), offsets.size() * sizeof(uint64_t));
+        dictionaryEntries[d].bytesOffset = writer.block(bytes.data(), bytes.size());
+        dictionaryEntries[d].bytesLength = bytes.size();
+    }
+
+    header.fileSize = writer.position();
+    writer.at(0, &header, sizeof(header));
+    writer.at(sizeof(header), entries.data(), entries.size() * sizeof(SnapshotColumn));
+    writer.at(sizeof(header) + entries.size() * sizeof(SnapshotColumn),
+              dictionaryEntries.data(), dictionaryEntries.size() * sizeof(SnapshotDictionary));
+    writer.finish(path);
+}
+
+std::unique_ptr<Table> Table::openSnapshot(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open snapshot: " + path);
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot open snapshot: " + path);
+    }
+    size_t fileSize = static_cast<size_t>(info.st_size);
+    if (fileSize < sizeof(SnapshotHeader)) {
+        ::close(fd);
+        corrupt(path, "too short");
+    }
+    void* address = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) throw std::runtime_error("Cannot map snapshot: " + path);
+
+    // the columns hold on to the mapping; it goes away with the last one
+    std::shared_ptr<const void> mapping(address, [fileSize](const void* p) {
+        ::munmap(const_cast<void*>(p), fileSize);
+    });
+    const char* base = static_cast<const char*>(address);
+
+    // offset of a block of count elements of type T, checked against the file
+    auto blockAt = [&](uint64_t offset, uint64_t count, size_t elementSize, size_t align) {
+        if (offset > fileSize || count > (fileSize - offset) / elementSize || offset % align != 0) {
+            corrupt(path, "block out of bounds");
+        }
+        return base + offset;
+    };
+
+    SnapshotHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) corrupt(path, "bad magic");
+    if (header.byteOrder != BYTE_ORDER_MARK) corrupt(path, "written with another byte order");
+    if (header.version != SNAPSHOT_VERSION) {
+        corrupt(path, "unsupported version " + std::to_string(header.version));
+    }
+    if (header.fileSize != fileSize) corrupt(path, "file size mismatch");
+
+    const auto* entries = reinterpret_cast<const SnapshotColumn*>(
+        blockAt(sizeof(SnapshotHeader), header.columnCount, sizeof(SnapshotColumn), 8));
+    const auto* dictionaryEntries = reinterpret_cast<const SnapshotDictionary*>(
+        blockAt(sizeof(SnapshotHeader) + header.columnCount * sizeof(SnapshotColumn),
+                header.dictionaryCount, sizeof(SnapshotDictionary), 8));
+
+    // dictionaries are rebuilt by interning their strings in code order, so
+    // the codes in the file stay valid and are read in place
+    std::vector<std::shared_ptr<StringDictionary>> dictionaries;
+    for (uint32_t d = 0; d < header.dictionaryCount; ++d) {
+        const SnapshotDictionary& entry = dictionaryEntries[d];
+        if (entry.count >= StringDictionary::NO_CODE) corrupt(path, "dictionary too large");
+        const auto* offsets = reinterpret_cast<const uint64_t*>(
+            blockAt(entry.offsetsOffset, entry.count + 1, sizeof(uint64_t), 8));
+        const char* bytes = blockAt(entry.bytesOffset, entry.bytesLength, 1, 1);
+        auto dictionary = std::make_shared<StringDictionary>();
+        for (uint64_t code = 0; code < entry.count; ++code) {
+            if (offsets[code] > offsets[code + 1] || offsets[code + 1] > entry.bytesLength) {
+                corrupt(path, "bad dictionary offsets");
+            }
+            std::string_view s(bytes + offsets[code], offsets[code + 1] - offsets[code]);
+            if (dictionary->intern(s) != code) corrupt(path, "duplicate dictionary string");
+        }
+        dictionaries.push_back(std::move(dictionary));
+    }
+
+    const char* tableName = blockAt(header.nameOffset, header.nameLength, 1, 1);
+    auto table = std::make_unique<Table>(std::string(tableName, header.nameLength));
+    size_t rows = header.rowCount;
+    for (uint32_t col = 0; col < header.columnCount; ++col) {
+        const SnapshotColumn& entry = entries[col];
+        std::string name(blockAt(entry.nameOffset, entry.nameLength, 1, 1), entry.nameLength);
+        if (entry.type > static_cast<uint32_t>(DataType::NULL_VALUE)) corrupt(path, "bad type in column " + name);
+        DataType type = static_cast<DataType>(entry.type);
+        if (entry.nullCount > rows || (type == DataType::NULL_VALUE && entry.nullCount != rows)) {
+            corrupt(path, "bad null count in column " + name);
+        }
+
+        Column::Arrays arrays;
+        arrays.validity = reinterpret_cast<const uint64_t*>(
+            blockAt(entry.validityOffset, (rows + 63) / 64, sizeof(uint64_t), 8));
+        std::shared_ptr<StringDictionary> dictionary;
+        if (entry.dictionary != NO_DICTIONARY) {
+            if (type != DataType::STRING || entry.dictionary >= dictionaries.size()) {
+                corrupt(path, "bad dictionary in column " + name);
+            }
+            dictionary = dictionaries[entry.dictionary];
+            arrays.values = blockAt(entry.valuesOffset, rows, sizeof(uint32_t), 4);
+        } else if (type == DataType::STRING) {
+            const auto* offsets = reinterpret_cast<const uint64_t*>(
+                blockAt(entry.valuesOffset, rows + 1, sizeof(uint64_t), 8));
+            arrays.bytes = blockAt(entry.bytesOffset, entry.bytesLength, 1, 1);
+            if (offsets[0] != 0 || offsets[rows] != entry.bytesLength) {
+                corrupt(path, "bad string offsets in column " + name);
+            }
+            arrays.values = offsets;
+        } else if (type != DataType::NULL_VALUE) {
+            arrays.values = blockAt(entry.valuesOffset, rows, 8, 8);
+        }
+        table->addColumn(name, Column::borrow(type, rows, entry.nullCount, arrays, mapping,
+                                              std::move(dictionary)));
+    }
+    return table;
+}
@@ -0,0 +1,207 @@
+#include "XXHash3.h"
+#include <cstring>
+
+namespace {
+
+constexpr uint64_t PRIME32_1 = 0x9E3779B1U;
+constexpr uint64_t PRIME32_2 = 0x85EBCA77U;
+constexpr uint64_t PRIME32_3 = 0xC2B2AE3DU;
+constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+constexpr uint64_t PRIME_MX1 = 0x165667919E3779F9ULL;
+constexpr uint64_t PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
+constexpr size_t SECRET_SIZE = 192;
+constexpr size_t STRIPE_LEN = 64;
+constexpr size_t SECRET_CONSUME_RATE = 8;
+constexpr size_t STRIPES_PER_BLOCK = (SECRET_SIZE - STRIPE_LEN) / SECRET_CONSUME_RATE;
+constexpr size_t BLOCK_LEN = STRIPE_LEN * STRIPES_PER_BLOCK;
+
+alignas(64) const uint8_t DEFAULT_SECRET[SECRET_SIZE] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+// little-endian reads; the reference defines the hash on LE byte order
+inline uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t read64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t mul128Fold64(uint64_t lhs, uint64_t rhs) {
+    __uint128_t product = static_cast<__uint128_t>(lhs) * rhs;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+}
+
+inline uint64_t xxh64Avalanche(uint64_t h) {
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+inline uint64_t avalanche(uint64_t h) {
+    h ^= h >> 37;
+    h *= PRIME_MX1;
+    h ^= h >> 32;
+    return h;
+}
+
+inline uint64_t rrmxmx(uint64_t h, uint64_t length) {
+    h ^= rotl64(h, 49) ^ rotl64(h, 24);
+    h *= PRIME_MX2;
+    h ^= (h >> 35) + length;
+    h *= PRIME_MX2;
+    return h ^ (h >> 28);
+}
+
+inline uint64_t mix16B(const uint8_t* in, const uint8_t* secret, uint64_t seed) {
+    return mul128Fold64(read64(in) ^ (read64(secret) + seed),
+                        read64(in + 8) ^ (read64(secret + 8) - seed));
+}
+
+uint64_t hashUpTo16(const uint8_t* in, size_t length, const uint8_t* secret, uint64_t seed) {
+    if (length > 8) {
+        uint64_t bitflip1 = (read64(secret + 24) ^ read64(secret + 32)) + seed;
+        uint64_t bitflip2 = (read64(secret + 40) ^ read64(secret + 48)) - seed;
+        uint64_t lo = read64(in) ^ bitflip1;
+        uint64_t hi = read64(in + length - 8) ^ bitflip2;
+        uint64_t acc = length + __builtin_bswap64(lo) + hi + mul128Fold64(lo, hi);
+        return avalanche(acc);
+    }
+    if (length >= 4) {
+        seed ^= static_cast<uint64_t>(__builtin_bswap32(static_cast<uint32_t>(seed))) << 32;
+        uint64_t bitflip = (read64(secret + 8) ^ read64(secret + 16)) - seed;
+        uint64_t input = read32(in + length - 4) + (static_cast<uint64_t>(read32(in)) << 32);
+        return rrmxmx(input ^ bitflip, length);
+    }
+    if (length > 0) {
+        uint32_t combined = (static_cast<uint32_t>(in[0]) << 16) | (static_cast<uint32_t>(in[length >> 1]) << 24) |
+                            static_cast<uint32_t>(in[length - 1]) | (static_cast<uint32_t>(length) << 8);
+        uint64_t bitflip = (read32(secret) ^ read32(secret + 4)) + seed;
+        return xxh64Avalanche(combined ^ bitflip);
+    }
+    return xxh64Avalanche(seed ^ read64(secret + 56) ^ read64(secret + 64));
+}
+
+uint64_t hash17To128(const uint8_t* in, size_t length, const uint8_t* secret, uint64_t seed) {
+    uint64_t acc = length * PRIME64_1;
+    if (length > 32) {
+        if (length > 64) {
+            if (length > 96) {
+                acc += mix16B(in + 48, secret + 96, seed);
+                acc += mix16B(in + length - 64, secret + 112, seed);
+            }
+            acc += mix16B(in + 32, secret + 64, seed);
+            acc += mix16B(in + length - 48, secret + 80, seed);
+        }
+        acc += mix16B(in + 16, secret + 32, seed);
+        acc += mix16B(in + length - 32, secret + 48, seed);
+    }
+    acc += mix16B(in, secret, seed);
+    acc += mix16B(in + length - 16, secret + 16, seed);
+    return avalanche(acc);
+}
+
+uint64_t hash129To240(const uint8_t* in, size_t length, const uint8_t* secret, uint64_t seed) {
+    uint64_t acc = length * PRIME64_1;
+    size_t rounds = length / 16;
+    for (size_t i = 0; i < 8; ++i) {
+        acc += mix16B(in + 16 * i, secret + 16 * i, seed);
+    }
+    acc = avalanche(acc);
+    for (size_t i = 8; i < rounds; ++i) {
+        acc += mix16B(in + 16 * i, secret + 16 * (i - 8) + 3, seed);
+    }
+    acc += mix16B(in + length - 16, secret + 136 - 17, seed);
+    return avalanche(acc);
+}
+
+inline void accumulateStripe(uint64_t* acc, const uint8_t* in, const uint8_t* secret) {
+    for (size_t i = 0; i < 8; ++i) {
+        uint64_t value = read64(in + 8 * i);
+        uint64_t key = value ^ read64(secret + 8 * i);
+        acc[i ^ 1] += value;
+        acc[i] += (key & 0xFFFFFFFFULL) * (key >> 32);
+    }
+}
+
+inline void scramble(uint64_t* acc, const uint8_t* secret) {
+    for (size_t i = 0; i < 8; ++i) {
+        uint64_t a = acc[i];
+        a ^= a >> 47;
+        a ^= read64(secret + 8 * i);
+        acc[i] = a * PRIME32_1;
+    }
+}
+
+uint64_t hashLong(const uint8_t* in, size_t length, const uint8_t* secret) {
+    uint64_t acc[8] = {PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3, PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1};
+
+    size_t blocks = (length - 1) / BLOCK_LEN;
+    for (size_t b = 0; b < blocks; ++b) {
+        for (size_t s = 0; s < STRIPES_PER_BLOCK; ++s) {
+            accumulateStripe(acc, in + b * BLOCK_LEN + s * STRIPE_LEN, secret + s * SECRET_CONSUME_RATE);
+        }
+        scramble(acc, secret + SECRET_SIZE - STRIPE_LEN);
+    }
+
+    size_t stripes = ((length - 1) - blocks * BLOCK_LEN) / STRIPE_LEN;
+    for (size_t s = 0; s < stripes; ++s) {
+        accumulateStripe(acc, in + blocks * BLOCK_LEN + s * STRIPE_LEN, secret + s * SECRET_CONSUME_RATE);
+    }
+    accumulateStripe(acc, in + length - STRIPE_LEN, secret + SECRET_SIZE - STRIPE_LEN - 7);
+
+    uint64_t result = length * PRIME64_1;
+    for (size_t i = 0; i < 4; ++i) {
+        const uint8_t* key = secret + 11 + 16 * i;
+        result += mul128Fold64(acc[2 * i] ^ read64(key), acc[2 * i + 1] ^ read64(key + 8));
+    }
+    return avalanche(result);
+}
+
+} // namespace
+
+uint64_t xxh3Hash64(const void* data, size_t length, uint64_t seed) {
+    const uint8_t* in = static_cast<const uint8_t*>(data);
+    if (length <= 16) return hashUpTo16(in, length, DEFAULT_SECRET, seed);
+    if (length <= 128) return hash17To128(in, length, DEFAULT_SECRET, seed);
+    if (length <= 240) return hash129To240(in, length, DEFAULT_SECRET, seed);
+    if (seed == 0) return hashLong(in, length, DEFAULT_SECRET);
+
+    // long inputs fold the seed into a derived secret instead
+    alignas(64) uint8_t secret[SECRET_SIZE];
+    for (size_t i = 0; i < SECRET_SIZE; i += 16) {
+        uint64_t lo = read64(DEFAULT_SECRET + i) + seed;
+        uint64_t hi = read64(DEFAULT_SECRET + i + 8) - seed;
+        std::memcpy(secret + i, &lo, sizeof(lo));
+        std::memcpy(secret + i + 8, &hi, sizeof(hi));
+    }
+    return hashLong(in, length, secret);
+}